@@ -0,0 +1,90 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+
+#ifdef FMCHNE_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+thread_local std::uint64_t t_allocations = 0;
+
+#ifdef FMCHNE_COUNT_ALLOCATIONS
+void countAllocation() {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    t_allocations++;
+}
+#endif
+
+} // namespace
+
+namespace AllocationCounter {
+
+bool enabled() {
+#ifdef FMCHNE_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::uint64_t count() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t threadCount() {
+    return t_allocations;
+}
+
+} // namespace AllocationCounter
+
+#ifdef FMCHNE_COUNT_ALLOCATIONS
+
+#if defined(__GLIBC__)
+// glibc lets the executable interpose the C allocator; operator new below
+// goes through malloc, so every heap allocation is counted exactly once
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* memory, std::size_t size);
+
+void* malloc(std::size_t size) {
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, std::size_t size) {
+    countAllocation();
+    return __libc_realloc(memory, size);
+}
+}
+#endif
+
+// The array, nothrow and sized forms all forward to these two by default
+void* operator new(std::size_t size) {
+#if !defined(__GLIBC__)
+    countAllocation();
+#endif
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#endif
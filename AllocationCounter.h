@@ -0,0 +1,20 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// Process-wide heap allocation counter. Only live in builds configured with
+// FMCHNE_COUNT_ALLOCATIONS, which replace the global operator new (and on
+// glibc also malloc, which is where Qt's containers allocate); otherwise
+// enabled() is false and the counts stay at zero.
+namespace AllocationCounter {
+
+bool enabled();
+// Allocations made on any thread since startup
+std::uint64_t count();
+// Allocations made by the calling thread, unaffected by background workers
+std::uint64_t threadCount();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,39 @@
+#include "AutoPlay.h"
+
+void AutoPlay::start(const AutoPlayConfig& config) {
+    m_config = config;
+    m_played = 0;
+    m_status = Status::Running;
+}
+
+void AutoPlay::stop() {
+    if (m_status == Status::Running) {
+        m_status = Status::Stopped;
+    }
+}
+
+AutoPlay::Status AutoPlay::checkLimits(const SpinEngine& engine) const {
+    if (m_played >= m_config.spins) {
+        return Status::Finished;
+    }
+    if (engine.state().money < m_config.stopBelow) {
+        return Status::BelowFloor;
+    }
+    if (!engine.canSpin()) {
+        return Status::Bust;
+    }
+    return Status::Running;
+}
+
+AutoPlay::Status AutoPlay::run(SpinEngine& engine, std::uint64_t maxSpins, SpinResult& last) {
+    if (m_status != Status::Running) {
+        return m_status;
+    }
+    for (std::uint64_t i = 0; i < maxSpins && checkLimits(engine) == Status::Running; ++i) {
+        last = engine.spin();
+        m_played++;
+    }
+    // A limit hit by the final spin is reported now, not on the next slice
+    m_status = checkLimits(engine);
+    return m_status;
+}
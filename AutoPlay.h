@@ -0,0 +1,47 @@
+#ifndef AUTOPLAY_H
+#define AUTOPLAY_H
+
+#include "SpinEngine.h"
+
+#include <cstdint>
+
+struct AutoPlayConfig {
+    std::uint64_t spins{100};
+    int stopBelow{0}; // Stop once the balance drops under this, in pence; 0 plays until bust
+};
+
+// Turbo mode: plays a batch of spins back to back, stopping on the spin
+// count, the balance floor or when the balance can no longer cover a spin.
+// Runs in slices so a UI can show progress between them; the caller owns
+// the engine and decides how often to render and persist.
+class AutoPlay {
+public:
+    enum class Status {
+        Idle,
+        Running,
+        Finished,   // Played the requested number of spins
+        BelowFloor, // Balance fell under stopBelow
+        Bust,       // Balance cannot cover another spin
+        Stopped     // Cancelled by the caller
+    };
+
+    void start(const AutoPlayConfig& config);
+    void stop();
+
+    // Plays up to maxSpins more; the last spin played is left in last.
+    // Returns the status afterwards, which stays Running until a limit is hit.
+    Status run(SpinEngine& engine, std::uint64_t maxSpins, SpinResult& last);
+
+    Status status() const { return m_status; }
+    bool isRunning() const { return m_status == Status::Running; }
+    std::uint64_t played() const { return m_played; }
+
+private:
+    Status checkLimits(const SpinEngine& engine) const;
+
+    AutoPlayConfig m_config;
+    Status m_status{Status::Idle};
+    std::uint64_t m_played{0};
+};
+
+#endif // AUTOPLAY_H
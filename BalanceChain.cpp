@@ -0,0 +1,414 @@
+#include "BalanceChain.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+// Destination states per unit of work. Fixed rather than split by thread
+// count so the per-block sums, merged in block order, come out the same
+// however many threads ran them.
+constexpr std::int64_t BLOCK_STATES = 1024;
+
+// States at the edge of the window holding less than this share of the
+// tolerance are pruned; each spin can only prune a few, so the total stays
+// far below the tolerance
+constexpr double PRUNE_FRACTION = 1e-8;
+
+// Runs one job on every thread of a fixed pool, the caller included, and
+// returns once all of them have finished. A spin on a narrow window costs
+// far less than starting threads for it, so they are started once.
+class StepPool {
+public:
+    explicit StepPool(unsigned threads) {
+        for (unsigned i = 1; i < threads; ++i) {
+            m_threads.emplace_back(&StepPool::work, this);
+        }
+    }
+
+    ~StepPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    void run(const std::function<void()>& job) {
+        if (m_threads.empty()) {
+            job();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            m_generation++;
+            m_running = static_cast<unsigned>(m_threads.size());
+        }
+        m_wake.notify_all();
+        job();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_running == 0; });
+    }
+
+private:
+    void work() {
+        std::uint64_t seen = 0;
+        for (;;) {
+            const std::function<void()>* job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&]() { return m_stop || m_generation != seen; });
+                if (m_stop) {
+                    return;
+                }
+                seen = m_generation;
+                job = m_job;
+            }
+            (*job)();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_running == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void()>* m_job{nullptr};
+    std::uint64_t m_generation{0};
+    unsigned m_running{0};
+    bool m_stop{false};
+};
+
+std::int64_t ceilDiv(std::int64_t a, std::int64_t b) {
+    return a >= 0 ? (a + b - 1) / b : -(-a / b);
+}
+
+// Probability over the states in play, one copy of the window per maxMoney
+// bin. Each copy is padded with zeros on both sides by the widest move, so
+// a spin can read any source state without bounds checks.
+struct Distribution {
+    std::int64_t lo{0};   // States in play are [lo, hi)
+    std::int64_t hi{0};
+    std::int64_t base{0}; // State stored just after the leading padding
+    std::size_t stride{0};
+    int layers{0};        // Bins that can hold probability so far
+    std::vector<double> values;
+
+    double* layer(int bin, int pad) { return values.data() + bin * stride + pad - base; }
+    const double* layer(int bin, int pad) const { return values.data() + bin * stride + pad - base; }
+};
+
+} // namespace
+
+std::vector<BalanceStep> balanceSteps(const Paytable& paytable, const OutcomeTable& table, const ReelSampler& reels) {
+    std::vector<BalanceStep> steps;
+    BalanceStep wipe;
+    wipe.wipe = true;
+    for (int i = 0; i < OUTCOME_TABLE_SIZE; ++i) {
+        const Reels combination = reelsFromIndex(i);
+        double probability = 1;
+        for (int r = 0; r < REEL_COUNT; ++r) {
+            probability *= reels.probability(r, combination[r]);
+        }
+        if (probability == 0) {
+            continue;
+        }
+
+        const OutcomeEntry& entry = table[i];
+        if (entry.wipe) {
+            wipe.probability += probability;
+            continue;
+        }
+        const int delta = entry.payout - paytable.cost;
+        auto step = std::find_if(steps.begin(), steps.end(), [delta](const BalanceStep& s) { return s.delta == delta; });
+        if (step == steps.end()) {
+            steps.push_back({delta, false, probability});
+        } else {
+            step->probability += probability;
+        }
+    }
+
+    std::sort(steps.begin(), steps.end(), [](const BalanceStep& a, const BalanceStep& b) { return a.delta < b.delta; });
+    if (wipe.probability > 0) {
+        steps.push_back(wipe);
+    }
+    return steps;
+}
+
+BalanceChainResult analyseSessions(const BalanceChainConfig& config) {
+    const auto started = std::chrono::steady_clock::now();
+    BalanceChainResult result;
+
+    const std::int64_t startMoney = config.startingMoney;
+    const int cost = config.paytable.cost;
+    const bool hasTarget = config.target > 0;
+
+    // Moves in states rather than pence; a wipe only ever leaves
+    std::vector<int> jumps;
+    std::vector<double> weights;
+    double wipe = 0;
+    int spacing = 0;
+    for (const BalanceStep& step : balanceSteps(config.paytable, makeOutcomeTable(config.paytable), ReelSampler(config.reels))) {
+        if (step.wipe) {
+            wipe = step.probability;
+        } else {
+            jumps.push_back(step.delta);
+            weights.push_back(step.probability);
+            spacing = std::gcd(spacing, std::abs(step.delta));
+        }
+    }
+    spacing = std::max(1, spacing);
+    for (int& jump : jumps) {
+        jump /= spacing;
+    }
+    result.stateSpacing = spacing;
+    const int down = jumps.empty() ? 0 : std::min(0, jumps.front());
+    const int up = jumps.empty() ? 0 : std::max(0, jumps.back());
+    const int pad = up - down;
+    const int moves = static_cast<int>(jumps.size());
+
+    // State i is a balance of startMoney + i * spacing. Sessions can spin from
+    // [lowest, beyond); without a target beyond is where the balance would
+    // overflow, and anything reaching it is reported as unresolved.
+    const std::int64_t lowest = ceilDiv(cost - startMoney, spacing);
+    const std::int64_t beyond = hasTarget ? ceilDiv(config.target - startMoney, spacing)
+                                          : (INT_MAX - startMoney) / spacing;
+
+    // Histogram of the running maximum, never below the starting balance
+    int bins = std::max(1, config.bins);
+    std::int64_t binWidth = config.binWidth;
+    if (binWidth <= 0) {
+        binWidth = hasTarget ? std::max<std::int64_t>(1, ceilDiv(config.target - startMoney, bins)) : 5 * cost;
+    }
+    if (hasTarget) {
+        bins = static_cast<int>(std::max<std::int64_t>(1, std::min<std::int64_t>(bins, ceilDiv(config.target - startMoney, binWidth))));
+    }
+    // First state whose balance falls in each bin, and the first past it
+    std::vector<std::int64_t> binStart(bins + 1);
+    binStart[0] = std::min<std::int64_t>(lowest, 0);
+    for (int k = 1; k < bins; ++k) {
+        binStart[k] = std::min(beyond, ceilDiv(k * binWidth, spacing));
+    }
+    binStart[bins] = beyond;
+    auto binOf = [&](std::int64_t state) {
+        return static_cast<int>(std::upper_bound(binStart.begin() + 1, binStart.end() - 1, state) - binStart.begin() - 1);
+    };
+
+    for (int k = 0; k < bins; ++k) {
+        const std::int64_t to = startMoney + (k + 1) * binWidth;
+        MaxMoneyBin bin;
+        bin.from = static_cast<int>(startMoney + k * binWidth);
+        bin.to = k + 1 < bins ? static_cast<int>(to) : (hasTarget ? config.target : INT_MAX);
+        result.maxMoney.push_back(bin);
+    }
+    if (hasTarget) {
+        result.maxMoney.push_back({config.target, INT_MAX, 0});
+    }
+
+    // Sessions that are over before they start
+    if (startMoney < cost || (hasTarget && startMoney >= config.target)) {
+        if (startMoney < cost) {
+            result.brokeProbability = 1;
+            result.maxMoney.front().probability = 1;
+        } else {
+            result.targetProbability = 1;
+            result.maxMoney.back().probability = 1;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    }
+
+    Distribution current;
+    current.lo = 0;
+    current.hi = 1;
+    current.base = 0;
+    current.stride = 1 + 2 * static_cast<std::size_t>(pad);
+    current.layers = 1;
+    current.values.assign(current.stride, 0.0);
+    current.layer(0, pad)[0] = 1;
+    Distribution next;
+
+    std::vector<double> layerMass(bins, 0.0);
+    layerMass[0] = 1;
+    std::vector<double> ended(bins, 0.0); // Broke or wiped, by the bin of their maxMoney
+    double reached = 0;                   // Got to beyond
+    double pruned = 0;
+    double inPlay = 1;
+    double finished = 0;
+    const double pruneBelow = config.tolerance * PRUNE_FRACTION;
+
+    unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    StepPool pool(std::max(1u, threads));
+    std::vector<double> blockMass;
+    std::atomic<std::int64_t> nextBlock{0};
+
+    while (inPlay > config.tolerance && result.spins < config.maxSpins && current.lo < current.hi) {
+        result.expectedSpins += inPlay;
+
+        // What leaves play on this spin, read from the states it comes from
+        for (int k = 0; k < current.layers; ++k) {
+            const double* from = current.layer(k, pad);
+            double broke = 0;
+            for (std::int64_t s = current.lo; s < std::min(current.hi, lowest - down); ++s) {
+                for (int x = 0; x < moves; ++x) {
+                    broke += s + jumps[x] < lowest ? from[s] * weights[x] : 0;
+                }
+            }
+            for (std::int64_t s = std::max(current.lo, beyond - up); s < current.hi; ++s) {
+                for (int x = 0; x < moves; ++x) {
+                    reached += s + jumps[x] >= beyond ? from[s] * weights[x] : 0;
+                }
+            }
+            result.brokeProbability += broke;
+            result.wipeProbability += wipe * layerMass[k];
+            ended[k] += broke + wipe * layerMass[k];
+        }
+
+        next.lo = std::max(lowest, current.lo + down);
+        next.hi = std::min(beyond, current.hi + up);
+        next.base = next.lo;
+        next.stride = static_cast<std::size_t>(next.hi - next.lo) + 2 * static_cast<std::size_t>(pad);
+        next.layers = next.hi > next.lo ? std::max(current.layers, binOf(next.hi - 1) + 1) : current.layers;
+        next.values.resize(next.layers * next.stride);
+        for (int k = 0; k < next.layers; ++k) {
+            double* row = next.values.data() + k * next.stride;
+            std::fill(row, row + pad, 0.0);
+            std::fill(row + next.stride - pad, row + next.stride, 0.0);
+        }
+
+        // Pull form: each destination state sums its sources, so blocks
+        // never write to the same state. Source states below a bin's first
+        // state can only arrive in it by setting a new maximum there, from
+        // this bin or any below; C holds that running total over bins.
+        const std::int64_t blocks = (next.hi - next.lo + BLOCK_STATES - 1) / BLOCK_STATES;
+        blockMass.assign(blocks * next.layers, 0.0);
+        nextBlock = 0;
+        const std::function<void()> job = [&]() {
+            std::vector<double> cumulative;
+            for (std::int64_t b = nextBlock++; b < blocks; b = nextBlock++) {
+                const std::int64_t first = next.lo + b * BLOCK_STATES;
+                const std::int64_t last = std::min(next.hi, first + BLOCK_STATES);
+                // Every source of [first, last) lies in [first - up, last - down)
+                cumulative.assign(static_cast<std::size_t>(last - first + pad), 0.0);
+                const double* c = cumulative.data() - (first - up);
+
+                for (int k = 0; k < next.layers; ++k) {
+                    double* to = next.layer(k, pad);
+                    const bool held = k < current.layers;
+                    const double* from = held ? current.layer(k, pad) : nullptr;
+                    if (held) {
+                        for (std::int64_t s = first - up; s < last - down; ++s) {
+                            cumulative[s - (first - up)] += from[s];
+                        }
+                    }
+
+                    const std::int64_t binFirst = k == 0 ? first : std::max(first, binStart[k]);
+                    const std::int64_t end = std::min(last, binStart[k + 1]);
+                    const std::int64_t stay = std::min(binFirst, end);
+                    double mass = 0;
+                    for (std::int64_t j = first; j < stay; ++j) {
+                        double sum = 0;
+                        if (held) {
+                            for (int x = 0; x < moves; ++x) {
+                                sum += weights[x] * from[j - jumps[x]];
+                            }
+                        }
+                        to[j] = sum;
+                        mass += sum;
+                    }
+                    for (std::int64_t j = stay; j < end; ++j) {
+                        double sum = 0;
+                        for (int x = 0; x < moves; ++x) {
+                            sum += weights[x] * c[j - jumps[x]];
+                        }
+                        to[j] = sum;
+                        mass += sum;
+                    }
+                    for (std::int64_t j = std::max(first, end); j < last; ++j) {
+                        to[j] = 0;
+                    }
+                    blockMass[b * next.layers + k] = mass;
+                }
+            }
+        };
+        if (blocks > 1) {
+            pool.run(job);
+        } else {
+            job();
+        }
+
+        std::fill(layerMass.begin(), layerMass.end(), 0.0);
+        for (std::int64_t b = 0; b < blocks; ++b) {
+            for (int k = 0; k < next.layers; ++k) {
+                layerMass[k] += blockMass[b * next.layers + k];
+            }
+        }
+
+        // Drop edge states that hardly matter, zeroing them so later spins
+        // still read zeros outside [lo, hi)
+        auto prune = [&](std::int64_t state) {
+            double column = 0;
+            for (int k = 0; k < next.layers; ++k) {
+                column += next.layer(k, pad)[state];
+            }
+            if (column >= pruneBelow) {
+                return false;
+            }
+            for (int k = 0; k < next.layers; ++k) {
+                double& value = next.layer(k, pad)[state];
+                layerMass[k] -= value;
+                value = 0;
+            }
+            pruned += column;
+            return true;
+        };
+        while (next.lo < next.hi && prune(next.lo)) {
+            next.lo++;
+        }
+        while (next.lo < next.hi && prune(next.hi - 1)) {
+            next.hi--;
+        }
+
+        std::swap(current, next);
+        result.spins++;
+        result.peakStates = std::max(result.peakStates, static_cast<std::size_t>(current.hi - current.lo));
+
+        inPlay = 0;
+        for (int k = 0; k < current.layers; ++k) {
+            inPlay += layerMass[k];
+        }
+        inPlay = std::max(0.0, inPlay);
+        finished = result.brokeProbability + result.wipeProbability + reached;
+        if (result.medianSpins == 0 && finished >= 0.5) {
+            result.medianSpins = result.spins;
+        }
+    }
+
+    for (int k = 0; k < bins; ++k) {
+        result.maxMoney[k].probability = ended[k];
+    }
+    if (hasTarget) {
+        result.targetProbability = reached;
+        result.maxMoney.back().probability = reached;
+        result.unresolved = inPlay + pruned;
+    } else {
+        result.unresolved = inPlay + pruned + reached;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
@@ -0,0 +1,86 @@
+#ifndef BALANCECHAIN_H
+#define BALANCECHAIN_H
+
+#include "ReelStrips.h"
+#include "SlotRules.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+ Exact session analysis: the balance as a Markov chain instead of sampled
+ sessions.
+
+ Every reel combination is enumerated with its probability and merged into
+ the few distinct ways one spin can move the balance. A session then ends
+ (an absorbing state) when the balance falls below the stake, when three
+ skulls wipe it, or, if a target is set, when the player walks away having
+ reached it.
+
+ The distribution over balances is pushed forward one spin at a time, a
+ sparse matrix-vector product with one entry per balance step, until
+ almost no probability is left in play. Balances only ever move by
+ multiples of the gcd of those steps, so states are spaced that far apart
+ (10p on the original machine). States far from the start with a
+ negligible share of the probability are pruned from the window, so the
+ work depends on how far a session wanders, not on how large the starting
+ balance is. The window is split into blocks that are worked on by a pool
+ of threads.
+
+ To get the distribution of the highest balance reached (GameState::maxMoney)
+ the state also carries which histogram bin the running maximum is in; one
+ copy of the balance vector per bin. Every probability here is exact up to
+ the unresolved remainder reported with the result.
+*/
+
+// One distinct way a spin moves the balance, merged over every reel
+// combination that does the same thing
+struct BalanceStep {
+    int delta{0};     // Change after the stake is taken and the payout added; unused for a wipe
+    bool wipe{false};
+    double probability{0};
+};
+
+// Sorted by delta, the wipe (if any) last
+std::vector<BalanceStep> balanceSteps(const Paytable& paytable, const OutcomeTable& table,
+                                      const ReelSampler& reels = ReelSampler());
+
+struct BalanceChainConfig {
+    int startingMoney{100};
+    int target{0};             // Walk away on reaching this balance; 0 plays until the session ends
+    int bins{32};              // maxMoney histogram bins above the starting balance
+    int binWidth{0};           // In pence; 0 splits the way to the target, or five stakes without one
+    double tolerance{1e-12};   // Stop once less than this probability is still in play
+    std::uint64_t maxSpins{100'000'000}; // Stop regardless after this many spins
+    unsigned threads{0};       // 0 picks std::thread::hardware_concurrency()
+    Paytable paytable;
+    ReelSet reels{uniformReels()};
+};
+
+struct MaxMoneyBin {
+    int from{0};  // Highest balance reached, in pence, inclusive
+    int to{0};    // Exclusive; the last bin is open ended
+    double probability{0};
+};
+
+struct BalanceChainResult {
+    double expectedSpins{0};     // Per session; a lower bound by at most the unresolved share
+    std::uint64_t medianSpins{0};
+    double brokeProbability{0};  // Balance fell below the stake
+    double wipeProbability{0};   // Three skulls
+    double targetProbability{0}; // Reached the target and walked away
+    double unresolved{0};        // Still in play when the iteration stopped, plus pruned tails
+    // The last bin is the target itself when one is set
+    std::vector<MaxMoneyBin> maxMoney;
+
+    std::uint64_t spins{0};      // Iterations run, one spin each
+    std::size_t peakStates{0};   // Widest window, in states per maxMoney bin
+    int stateSpacing{1};         // Pence between neighbouring states
+    double seconds{0};
+
+    double bustProbability() const { return brokeProbability + wipeProbability; }
+};
+
+BalanceChainResult analyseSessions(const BalanceChainConfig& config);
+
+#endif // BALANCECHAIN_H
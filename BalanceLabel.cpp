@@ -0,0 +1,144 @@
+#include "BalanceLabel.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+namespace {
+
+const QColor GOLD("#FFD700");
+const QColor BOX_COLOR(0, 0, 0, 100);
+
+// The box the old stylesheet gave the label
+constexpr int MARGIN = 10;
+constexpr int BORDER = 2;
+constexpr int PADDING_X = 20;
+constexpr int PADDING_Y = 10;
+constexpr int RADIUS = 15;
+
+const QString PREFIX = QStringLiteral("Balance: £");
+
+int glyphIndex(char glyph) {
+    return glyph == '.' ? 10 : glyph - '0';
+}
+
+QChar glyphChar(int index) {
+    return index == 10 ? QChar('.') : QChar('0' + index);
+}
+
+} // namespace
+
+BalanceLabel::BalanceLabel(QWidget *parent)
+    : QWidget(parent)
+{
+    setPence(0);
+}
+
+void BalanceLabel::setPence(int pence) {
+    if (pence == m_pence) {
+        return;
+    }
+    m_pence = pence;
+
+    // Written backwards from the pence, then the pounds
+    const unsigned amount = static_cast<unsigned>(pence < 0 ? 0 : pence);
+    std::array<char, 16> reversed;
+    int length = 0;
+    reversed[length++] = static_cast<char>('0' + amount % 10);
+    reversed[length++] = static_cast<char>('0' + amount / 10 % 10);
+    reversed[length++] = '.';
+    unsigned pounds = amount / 100;
+    do {
+        reversed[length++] = static_cast<char>('0' + pounds % 10);
+        pounds /= 10;
+    } while (pounds > 0);
+
+    for (int i = 0; i < length; ++i) {
+        m_text[i] = reversed[length - 1 - i];
+    }
+    m_length = length;
+    update();
+}
+
+int BalanceLabel::glyphAdvance(char glyph) const {
+    return fontMetrics().horizontalAdvance(glyphChar(glyphIndex(glyph)));
+}
+
+int BalanceLabel::textWidth() const {
+    int width = fontMetrics().horizontalAdvance(PREFIX);
+    for (int i = 0; i < m_length; ++i) {
+        width += glyphAdvance(m_text[i]);
+    }
+    return width;
+}
+
+QSize BalanceLabel::sizeHint() const {
+    const int frame = MARGIN + BORDER;
+    return QSize(textWidth() + 2 * (frame + PADDING_X),
+                 fontMetrics().height() + 2 * (frame + PADDING_Y));
+}
+
+void BalanceLabel::ensureAtlas() {
+    const qreal dpr = devicePixelRatioF();
+    if (!m_atlas.isNull() && m_atlasDpr == dpr && m_atlasFont == font()) {
+        return;
+    }
+
+    const QFontMetrics metrics = fontMetrics();
+    m_prefixWidth = metrics.horizontalAdvance(PREFIX);
+    int x = m_prefixWidth;
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        m_glyphX[i] = x;
+        m_glyphWidth[i] = metrics.horizontalAdvance(glyphChar(i));
+        x += m_glyphWidth[i];
+    }
+
+    const int height = metrics.height();
+    m_atlas = QPixmap(QSize(x, height) * dpr);
+    m_atlas.setDevicePixelRatio(dpr);
+    m_atlas.fill(Qt::transparent);
+
+    QPainter painter(&m_atlas);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font());
+    painter.setPen(GOLD);
+    painter.drawText(QRect(0, 0, m_prefixWidth, height), Qt::AlignLeft | Qt::AlignVCenter, PREFIX);
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        painter.drawText(QRect(m_glyphX[i], 0, m_glyphWidth[i], height),
+                         Qt::AlignLeft | Qt::AlignVCenter, QString(glyphChar(i)));
+    }
+
+    m_atlasDpr = dpr;
+    m_atlasFont = font();
+}
+
+void BalanceLabel::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+    ensureAtlas();
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(GOLD, BORDER));
+    painter.setBrush(BOX_COLOR);
+    const qreal inset = MARGIN + BORDER / 2.0;
+    painter.drawRoundedRect(QRectF(rect()).adjusted(inset, inset, -inset, -inset), RADIUS, RADIUS);
+
+    int width = m_prefixWidth;
+    for (int i = 0; i < m_length; ++i) {
+        width += m_glyphWidth[glyphIndex(m_text[i])];
+    }
+    const int height = m_atlas.height() / m_atlasDpr;
+    int x = (this->width() - width) / 2;
+    const int y = (this->height() - height) / 2;
+
+    // Source rects are in device pixels
+    auto blit = [&](int sourceX, int sourceWidth) {
+        painter.drawPixmap(QRect(x, y, sourceWidth, height), m_atlas,
+                           QRectF(sourceX * m_atlasDpr, 0, sourceWidth * m_atlasDpr, height * m_atlasDpr));
+        x += sourceWidth;
+    };
+    blit(0, m_prefixWidth);
+    for (int i = 0; i < m_length; ++i) {
+        const int glyph = glyphIndex(m_text[i]);
+        blit(m_glyphX[glyph], m_glyphWidth[glyph]);
+    }
+}
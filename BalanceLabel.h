@@ -0,0 +1,54 @@
+#ifndef BALANCELABEL_H
+#define BALANCELABEL_H
+
+#include <QFont>
+#include <QPixmap>
+#include <QWidget>
+#include <array>
+
+/*
+ The "Balance: £x.yy" box on the game screen.
+
+ The balance changes on nearly every spin, and formatting it into a QString
+ for a QLabel cost heap allocations each time. Here the amount is written
+ into a fixed character buffer and painted from a glyph atlas (the prefix,
+ the ten digits and the point, rasterized once per device pixel ratio and
+ font), so setPence() never allocates.
+*/
+class BalanceLabel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit BalanceLabel(QWidget *parent = nullptr);
+
+    // Repaints only if the amount changed
+    void setPence(int pence);
+    int pence() const { return m_pence; }
+
+    // Width of the text alone, without the box around it
+    int textWidth() const;
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static constexpr int GLYPH_COUNT = 11; // "0"-"9", then "."
+
+    void ensureAtlas();
+    int glyphAdvance(char glyph) const;
+
+    int m_pence = -1;
+    // Pounds, point and pence; 10 digits cover any int
+    std::array<char, 16> m_text{};
+    int m_length = 0;
+
+    QPixmap m_atlas;
+    qreal m_atlasDpr = 0;
+    QFont m_atlasFont;
+    int m_prefixWidth = 0;
+    std::array<int, GLYPH_COUNT> m_glyphX{};
+    std::array<int, GLYPH_COUNT> m_glyphWidth{};
+};
+
+#endif // BALANCELABEL_H
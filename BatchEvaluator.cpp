@@ -0,0 +1,308 @@
+#include "BatchEvaluator.h"
+
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FMCHNE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr std::uint8_t SKULL = static_cast<std::uint8_t>(Symbol::Skull);
+constexpr std::uint8_t BELL = static_cast<std::uint8_t>(Symbol::Bell);
+
+#ifdef FMCHNE_X86_DISPATCH
+
+/*
+ Every SIMD path classifies with the same byte-wise formula:
+   outcome = Pair if any two reels match and there are no skulls
+   outcome = ThreeOfAKind + (reel0 == Bell) if all three match
+   outcome = TwoSkulls / ThreeSkulls if the skull count is 2 / 3
+ applied in that order so later rules override earlier ones, which is the
+ same priority the scalar rules check them in.
+*/
+
+__attribute__((target("sse4.2")))
+std::size_t evaluateSse42(const std::uint8_t* r0, const std::uint8_t* r1, const std::uint8_t* r2,
+                          std::size_t count, const std::int16_t* outcomePayouts,
+                          std::int16_t* payouts, std::uint8_t* outcomes) {
+    const __m128i skull = _mm_set1_epi8(SKULL);
+    const __m128i bell = _mm_set1_epi8(BELL);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi8(2);
+    const __m128i twoSkulls = _mm_set1_epi8(static_cast<char>(Outcome::TwoSkulls));
+    const __m128i threeSkulls = _mm_set1_epi8(static_cast<char>(Outcome::ThreeSkulls));
+
+    // Split the int16 payout table into low and high bytes for pshufb lookups
+    alignas(16) std::uint8_t lo[16];
+    alignas(16) std::uint8_t hi[16];
+    for (int i = 0; i < 16; ++i) {
+        lo[i] = static_cast<std::uint8_t>(outcomePayouts[i] & 0xFF);
+        hi[i] = static_cast<std::uint8_t>((outcomePayouts[i] >> 8) & 0xFF);
+    }
+    const __m128i loTable = _mm_load_si128(reinterpret_cast<const __m128i*>(lo));
+    const __m128i hiTable = _mm_load_si128(reinterpret_cast<const __m128i*>(hi));
+
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + i));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r2 + i));
+
+        // Compare masks are -1 per match, so negating their sum gives the count
+        const __m128i skulls = _mm_sub_epi8(zero, _mm_add_epi8(_mm_add_epi8(
+            _mm_cmpeq_epi8(a, skull), _mm_cmpeq_epi8(b, skull)), _mm_cmpeq_epi8(c, skull)));
+        const __m128i eq01 = _mm_cmpeq_epi8(a, b);
+        const __m128i eq12 = _mm_cmpeq_epi8(b, c);
+        const __m128i eq02 = _mm_cmpeq_epi8(a, c);
+        const __m128i three = _mm_and_si128(eq01, eq12);
+        const __m128i pair = _mm_and_si128(_mm_or_si128(_mm_or_si128(eq01, eq12), eq02),
+                                           _mm_cmpeq_epi8(skulls, zero));
+
+        __m128i outcome = _mm_and_si128(pair, one);
+        outcome = _mm_blendv_epi8(outcome, _mm_add_epi8(two, _mm_and_si128(_mm_cmpeq_epi8(a, bell), one)), three);
+        outcome = _mm_blendv_epi8(outcome, twoSkulls, _mm_cmpeq_epi8(skulls, two));
+        outcome = _mm_blendv_epi8(outcome, threeSkulls, _mm_cmpeq_epi8(skulls, _mm_set1_epi8(3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outcomes + i), outcome);
+
+        const __m128i payLo = _mm_shuffle_epi8(loTable, outcome);
+        const __m128i payHi = _mm_shuffle_epi8(hiTable, outcome);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(payouts + i), _mm_unpacklo_epi8(payLo, payHi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(payouts + i + 8), _mm_unpackhi_epi8(payLo, payHi));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+std::size_t evaluateAvx2(const std::uint8_t* r0, const std::uint8_t* r1, const std::uint8_t* r2,
+                         std::size_t count, const std::int16_t* outcomePayouts,
+                         std::int16_t* payouts, std::uint8_t* outcomes) {
+    const __m256i skull = _mm256_set1_epi8(SKULL);
+    const __m256i bell = _mm256_set1_epi8(BELL);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+    const __m256i twoSkulls = _mm256_set1_epi8(static_cast<char>(Outcome::TwoSkulls));
+    const __m256i threeSkulls = _mm256_set1_epi8(static_cast<char>(Outcome::ThreeSkulls));
+
+    alignas(16) std::uint8_t lo[16];
+    alignas(16) std::uint8_t hi[16];
+    for (int i = 0; i < 16; ++i) {
+        lo[i] = static_cast<std::uint8_t>(outcomePayouts[i] & 0xFF);
+        hi[i] = static_cast<std::uint8_t>((outcomePayouts[i] >> 8) & 0xFF);
+    }
+    // vpshufb looks up within each 128-bit lane, so both lanes get the table
+    const __m256i loTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lo)));
+    const __m256i hiTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(hi)));
+
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r0 + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r1 + i));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r2 + i));
+
+        const __m256i skulls = _mm256_sub_epi8(zero, _mm256_add_epi8(_mm256_add_epi8(
+            _mm256_cmpeq_epi8(a, skull), _mm256_cmpeq_epi8(b, skull)), _mm256_cmpeq_epi8(c, skull)));
+        const __m256i eq01 = _mm256_cmpeq_epi8(a, b);
+        const __m256i eq12 = _mm256_cmpeq_epi8(b, c);
+        const __m256i eq02 = _mm256_cmpeq_epi8(a, c);
+        const __m256i three = _mm256_and_si256(eq01, eq12);
+        const __m256i pair = _mm256_and_si256(_mm256_or_si256(_mm256_or_si256(eq01, eq12), eq02),
+                                              _mm256_cmpeq_epi8(skulls, zero));
+
+        __m256i outcome = _mm256_and_si256(pair, one);
+        outcome = _mm256_blendv_epi8(outcome, _mm256_add_epi8(two, _mm256_and_si256(_mm256_cmpeq_epi8(a, bell), one)), three);
+        outcome = _mm256_blendv_epi8(outcome, twoSkulls, _mm256_cmpeq_epi8(skulls, two));
+        outcome = _mm256_blendv_epi8(outcome, threeSkulls, _mm256_cmpeq_epi8(skulls, _mm256_set1_epi8(3)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(outcomes + i), outcome);
+
+        // Unpack interleaves within lanes, so swap the middle quarters back into order
+        const __m256i payLo = _mm256_shuffle_epi8(loTable, outcome);
+        const __m256i payHi = _mm256_shuffle_epi8(hiTable, outcome);
+        const __m256i first = _mm256_unpacklo_epi8(payLo, payHi);
+        const __m256i second = _mm256_unpackhi_epi8(payLo, payHi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(payouts + i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(payouts + i + 16), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+std::size_t evaluateAvx512(const std::uint8_t* r0, const std::uint8_t* r1, const std::uint8_t* r2,
+                           std::size_t count, const std::int16_t* outcomePayouts,
+                           std::int16_t* payouts, std::uint8_t* outcomes) {
+    const __m512i skull = _mm512_set1_epi8(SKULL);
+    const __m512i bell = _mm512_set1_epi8(BELL);
+    const __m512i one = _mm512_set1_epi8(1);
+    const __m512i two = _mm512_set1_epi8(2);
+    const __m512i twoSkulls = _mm512_set1_epi8(static_cast<char>(Outcome::TwoSkulls));
+    const __m512i threeSkulls = _mm512_set1_epi8(static_cast<char>(Outcome::ThreeSkulls));
+
+    alignas(64) std::int16_t table[32]{};
+    std::copy(outcomePayouts, outcomePayouts + 16, table);
+    const __m512i payoutTable = _mm512_load_si512(table);
+
+    std::size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        const __m512i a = _mm512_loadu_si512(r0 + i);
+        const __m512i b = _mm512_loadu_si512(r1 + i);
+        const __m512i c = _mm512_loadu_si512(r2 + i);
+
+        const __mmask64 sa = _mm512_cmpeq_epi8_mask(a, skull);
+        const __mmask64 sb = _mm512_cmpeq_epi8_mask(b, skull);
+        const __mmask64 sc = _mm512_cmpeq_epi8_mask(c, skull);
+        const __mmask64 anySkull = sa | sb | sc;
+        const __mmask64 twoOrMore = (sa & sb) | (sb & sc) | (sa & sc);
+        const __mmask64 allSkull = sa & sb & sc;
+
+        const __mmask64 eq01 = _mm512_cmpeq_epi8_mask(a, b);
+        const __mmask64 eq12 = _mm512_cmpeq_epi8_mask(b, c);
+        const __mmask64 eq02 = _mm512_cmpeq_epi8_mask(a, c);
+        const __mmask64 three = eq01 & eq12;
+        const __mmask64 pair = (eq01 | eq12 | eq02) & ~anySkull;
+
+        __m512i outcome = _mm512_maskz_mov_epi8(pair, one);
+        outcome = _mm512_mask_blend_epi8(three, outcome,
+            _mm512_mask_add_epi8(two, _mm512_cmpeq_epi8_mask(a, bell), two, one));
+        outcome = _mm512_mask_blend_epi8(twoOrMore & ~allSkull, outcome, twoSkulls);
+        outcome = _mm512_mask_blend_epi8(allSkull, outcome, threeSkulls);
+        _mm512_storeu_si512(outcomes + i, outcome);
+
+        // Widen each half of the just-stored classes to int16 indices into the payout table
+        const __m512i low = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(outcomes + i)));
+        const __m512i high = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(outcomes + i + 32)));
+        _mm512_storeu_si512(payouts + i, _mm512_permutexvar_epi16(low, payoutTable));
+        _mm512_storeu_si512(payouts + i + 32, _mm512_permutexvar_epi16(high, payoutTable));
+    }
+    return i;
+}
+
+#endif // FMCHNE_X86_DISPATCH
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef FMCHNE_X86_DISPATCH
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) {
+            return SimdLevel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return SimdLevel::Sse42;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx512:
+            return "AVX-512BW";
+        case SimdLevel::Avx2:
+            return "AVX2";
+        case SimdLevel::Sse42:
+            return "SSE4.2";
+        case SimdLevel::Scalar:
+            break;
+    }
+    return "scalar";
+}
+
+BatchEvaluator::BatchEvaluator(const Paytable& paytable, SimdLevel level)
+    : m_paytable(paytable)
+    , m_outcomes(makeOutcomeTable(paytable))
+    , m_level(std::min(level, detectSimdLevel()))
+{
+    for (int i = 0; i < OUTCOME_COUNT; ++i) {
+        m_outcomePayouts[i] = static_cast<std::int16_t>(payoutFor(static_cast<Outcome>(i), paytable));
+    }
+}
+
+void BatchEvaluator::evaluateScalar(const SpinBatch& batch, std::size_t begin,
+                                    std::int16_t* payouts, Outcome* outcomes) const {
+    for (std::size_t i = begin; i < batch.count; ++i) {
+        const OutcomeEntry& entry = m_outcomes[outcomeIndex(
+            static_cast<Symbol>(batch.reels[0][i]),
+            static_cast<Symbol>(batch.reels[1][i]),
+            static_cast<Symbol>(batch.reels[2][i]))];
+        payouts[i] = entry.payout;
+        outcomes[i] = entry.outcome;
+    }
+}
+
+void BatchEvaluator::evaluate(const SpinBatch& batch, std::int16_t* payouts, Outcome* outcomes) const {
+    std::size_t done = 0;
+#ifdef FMCHNE_X86_DISPATCH
+    auto* outcomeBytes = reinterpret_cast<std::uint8_t*>(outcomes);
+    switch (m_level) {
+        case SimdLevel::Avx512:
+            done = evaluateAvx512(batch.reels[0], batch.reels[1], batch.reels[2], batch.count,
+                                  m_outcomePayouts, payouts, outcomeBytes);
+            break;
+        case SimdLevel::Avx2:
+            done = evaluateAvx2(batch.reels[0], batch.reels[1], batch.reels[2], batch.count,
+                                m_outcomePayouts, payouts, outcomeBytes);
+            break;
+        case SimdLevel::Sse42:
+            done = evaluateSse42(batch.reels[0], batch.reels[1], batch.reels[2], batch.count,
+                                 m_outcomePayouts, payouts, outcomeBytes);
+            break;
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+    // Tail (or everything, without SIMD) goes through the outcome table
+    evaluateScalar(batch, done, payouts, outcomes);
+}
+
+SessionScore BatchEvaluator::scoreSession(const SpinBatch& batch, int startingMoney) const {
+    constexpr std::size_t BLOCK = 4096;
+    std::int16_t payouts[BLOCK];
+    Outcome outcomes[BLOCK];
+
+    SessionScore score;
+    int money = startingMoney;
+    int maxMoney = startingMoney;
+    const int cost = m_paytable.cost;
+
+    for (std::size_t begin = 0; begin < batch.count; begin += BLOCK) {
+        SpinBatch block;
+        block.count = std::min(BLOCK, batch.count - begin);
+        for (int r = 0; r < REEL_COUNT; ++r) {
+            block.reels[r] = batch.reels[r] + begin;
+        }
+        evaluate(block, payouts, outcomes);
+
+        for (std::size_t i = 0; i < block.count; ++i) {
+            if (money < cost) {
+                score.bust = true;
+                break;
+            }
+            const int settled = money - cost + payouts[i];
+            const bool wipe = outcomes[i] == Outcome::ThreeSkulls && m_paytable.threeSkullsWipe;
+            const int next = wipe || settled < 0 ? 0 : settled;
+            score.moneyEarnt += next > money ? next - money : 0;
+            maxMoney = std::max(maxMoney, next);
+            money = next;
+            score.spinsPlayed++;
+        }
+        if (score.bust) {
+            break;
+        }
+    }
+
+    score.bust = score.bust || money < cost;
+    score.finalMoney = money;
+    score.maxMoney = maxMoney;
+    return score;
+}
@@ -0,0 +1,62 @@
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+
+#include "SlotRules.h"
+
+#include <cstddef>
+#include <cstdint>
+
+enum class SimdLevel {
+    Scalar,
+    Sse42,
+    Avx2,
+    Avx512
+};
+
+// Best instruction set the running CPU supports, checked once
+SimdLevel detectSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Structure-of-arrays view of a run of spins, one symbol index lane per reel
+struct SpinBatch {
+    const std::uint8_t* reels[REEL_COUNT]{};
+    std::size_t count{0};
+};
+
+struct SessionScore {
+    std::size_t spinsPlayed{0};
+    int finalMoney{0};
+    int maxMoney{0};
+    std::int64_t moneyEarnt{0}; // Sum of the positive balance changes
+    bool bust{false};           // Balance fell below the cost before the batch ran out
+};
+
+// Scores large batches of pre-rolled spins. Outcome classes and payouts are
+// computed 16/32/64 spins at a time with SSE4.2/AVX2/AVX-512BW byte compares,
+// picked at runtime, with a table-driven scalar path as the fallback.
+class BatchEvaluator {
+public:
+    explicit BatchEvaluator(const Paytable& paytable = Paytable{}, SimdLevel level = detectSimdLevel());
+
+    SimdLevel level() const { return m_level; }
+    const Paytable& paytable() const { return m_paytable; }
+
+    // Payout added after the stake (as in OutcomeEntry::payout) and outcome class per spin
+    void evaluate(const SpinBatch& batch, std::int16_t* payouts, Outcome* outcomes) const;
+
+    // Plays the batch as one session from startingMoney, stopping once the
+    // balance can no longer cover the cost. Payouts are evaluated in vector
+    // blocks, then one scan pass carries the balance through each block with
+    // money = max(0, money - cost + payout), wipes forcing zero.
+    SessionScore scoreSession(const SpinBatch& batch, int startingMoney) const;
+
+private:
+    void evaluateScalar(const SpinBatch& batch, std::size_t begin, std::int16_t* payouts, Outcome* outcomes) const;
+
+    Paytable m_paytable;
+    OutcomeTable m_outcomes;
+    std::int16_t m_outcomePayouts[16]{}; // Indexed by Outcome, padded for shuffles
+    SimdLevel m_level;
+};
+
+#endif // BATCHEVALUATOR_H
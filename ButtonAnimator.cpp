@@ -0,0 +1,72 @@
+#include "ButtonAnimator.h"
+
+#include "AllocationCounter.h"
+#include "RotatableButton.h"
+
+#include <QtMath>
+
+namespace {
+
+constexpr qreal HOVER_ROTATION = 45;
+constexpr int HOVER_DURATION_MS = 200;
+constexpr qreal PRESSED_SCALE = 0.9;
+constexpr int PRESS_DURATION_MS = 100;
+
+std::uint64_t g_retargetAllocations = 0; // UI thread only
+std::uint64_t g_retargets = 0;
+
+} // namespace
+
+ButtonAnimator::ButtonAnimator(RotatableButton* button)
+    : QObject(button)
+    , m_button(button)
+    , m_rotation(button, "rotation", this)
+    , m_scale(button, "scale", this)
+{
+}
+
+void ButtonAnimator::hoverEnter() {
+    m_button->setShadowVisible(true);
+    retarget(m_rotation, m_button->rotation(), HOVER_ROTATION, HOVER_ROTATION, HOVER_DURATION_MS);
+}
+
+void ButtonAnimator::hoverLeave() {
+    m_button->setShadowVisible(false);
+    retarget(m_rotation, m_button->rotation(), 0, HOVER_ROTATION, HOVER_DURATION_MS);
+}
+
+void ButtonAnimator::press() {
+    retarget(m_scale, m_button->scale(), PRESSED_SCALE, 1 - PRESSED_SCALE, PRESS_DURATION_MS);
+}
+
+void ButtonAnimator::release() {
+    retarget(m_scale, m_button->scale(), 1, 1 - PRESSED_SCALE, PRESS_DURATION_MS);
+}
+
+std::uint64_t ButtonAnimator::retargetAllocations() {
+    return g_retargetAllocations;
+}
+
+std::uint64_t ButtonAnimator::retargetCount() {
+    return g_retargets;
+}
+
+void ButtonAnimator::retarget(QPropertyAnimation& animation, qreal current, qreal target,
+                              qreal fullDistance, int fullDuration) {
+    const std::uint64_t allocationsBefore = AllocationCounter::threadCount();
+
+    animation.stop();
+    const qreal remaining = qAbs(target - current) / fullDistance;
+    const int duration = qRound(fullDuration * qMin<qreal>(remaining, 1));
+    if (duration > 0) {
+        animation.setDuration(duration);
+        animation.setStartValue(current);
+        animation.setEndValue(target);
+        animation.start();
+    } else {
+        m_button->setProperty(animation.propertyName().constData(), target);
+    }
+
+    g_retargetAllocations += AllocationCounter::threadCount() - allocationsBefore;
+    g_retargets++;
+}
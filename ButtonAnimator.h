@@ -0,0 +1,46 @@
+#ifndef BUTTONANIMATOR_H
+#define BUTTONANIMATOR_H
+
+#include <QObject>
+#include <QPropertyAnimation>
+#include <cstdint>
+
+class RotatableButton;
+
+/*
+ Owns every animation a button ever runs: one rotation animation for hover,
+ one scale animation for press. They are created once
+ with the button and retargeted in place, starting from whatever value the
+ property has right now. A quick enter/leave therefore reverses smoothly
+ instead of stacking a second animation that jumps to 0 or 45, and steady
+ state interaction does not touch the heap.
+*/
+class ButtonAnimator : public QObject {
+    Q_OBJECT
+
+public:
+    // Parented to the button, so it lives and dies with it
+    explicit ButtonAnimator(RotatableButton* button);
+
+    void hoverEnter();
+    void hoverLeave();
+    void press();
+    void release();
+
+    // Heap allocations seen inside retargets, across all buttons; only
+    // counted in FMCHNE_COUNT_ALLOCATIONS builds
+    static std::uint64_t retargetAllocations();
+    static std::uint64_t retargetCount();
+
+private:
+    // Runs from the current value to target, taking the share of fullDuration
+    // that the remaining distance is of fullDistance
+    void retarget(QPropertyAnimation& animation, qreal current, qreal target,
+                  qreal fullDistance, int fullDuration);
+
+    RotatableButton* m_button;
+    QPropertyAnimation m_rotation;
+    QPropertyAnimation m_scale;
+};
+
+#endif // BUTTONANIMATOR_H
@@ -0,0 +1,64 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Power-of-two bucketed latency histogram. Recording is a couple of relaxed
+// atomic increments, so it can be fed from any thread on a hot path.
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS = 48; // Bucket i holds [2^(i-1), 2^i) ns; the last one is open ended
+
+    void record(std::uint64_t nanoseconds) {
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && (std::uint64_t{1} << bucket) <= nanoseconds) {
+            bucket++;
+        }
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (nanoseconds > max && !m_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given quantile, capped at the max, in nanoseconds
+    std::uint64_t percentile(double quantile) const {
+        const std::uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKETS; ++bucket) {
+            seen += m_buckets[bucket].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                const std::uint64_t bound = std::uint64_t{1} << bucket;
+                return bound < max() ? bound : max();
+            }
+        }
+        return max();
+    }
+
+    std::string summary() const {
+        char text[160];
+        std::snprintf(text, sizeof(text), "n=%llu p50<%.1fus p95<%.1fus p99<%.1fus max=%.1fus",
+                      static_cast<unsigned long long>(count()),
+                      percentile(0.50) / 1000.0, percentile(0.95) / 1000.0,
+                      percentile(0.99) / 1000.0, max() / 1000.0);
+        return text;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+#endif // LATENCYHISTOGRAM_H
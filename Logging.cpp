@@ -0,0 +1,181 @@
+#include "Logging.h"
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+Q_LOGGING_CATEGORY(lcSpin, "fmchne.spin", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcScreen, "fmchne.screen", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcSave, "fmchne.save", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcPerf, "fmchne.perf", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcPaytable, "fmchne.paytable", QtInfoMsg)
+
+namespace {
+
+// The context only holds pointers to string literals, so keeping them is safe
+struct LogRecord {
+    QtMsgType type{QtDebugMsg};
+    const char* category{nullptr};
+    const char* file{nullptr};
+    const char* function{nullptr};
+    int line{0};
+    QString message;
+};
+
+/*
+ Bounded multi-producer queue (Vyukov): any thread may log, so producers
+ claim cells with a CAS on the enqueue position and publish through the
+ cell's sequence number. The single consumer is the flusher, or whoever
+ holds the drain mutex.
+*/
+class LogQueue {
+public:
+    static constexpr std::size_t CAPACITY = 4096;
+
+    LogQueue() {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(LogRecord&& record) {
+        std::size_t pos = m_enqueue.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[pos & (CAPACITY - 1)];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = std::move(record);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, serialized by the caller
+    bool pop(LogRecord& record) {
+        Cell& cell = m_cells[m_dequeue & (CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != m_dequeue + 1) {
+            return false;
+        }
+        record = std::move(cell.record);
+        cell.sequence.store(m_dequeue + CAPACITY, std::memory_order_release);
+        m_dequeue++;
+        return true;
+    }
+
+    std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        LogRecord record;
+    };
+
+    Cell m_cells[CAPACITY];
+    alignas(64) std::atomic<std::size_t> m_enqueue{0};
+    alignas(64) std::size_t m_dequeue{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+struct SinkState {
+    LogQueue queue;
+    std::mutex drainMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stop{false};
+    std::uint64_t reportedDrops{0};
+    QtMessageHandler previous{nullptr};
+    std::thread flusher;
+};
+
+// Flush often enough to read along, rarely enough to batch a burst of spins
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(50);
+
+SinkState* g_sink = nullptr;
+
+// Formats and writes everything queued so far as one stderr write
+void drain(SinkState& sink) {
+    std::lock_guard<std::mutex> lock(sink.drainMutex);
+
+    QByteArray batch;
+    LogRecord record;
+    while (sink.queue.pop(record)) {
+        const QMessageLogContext context(record.file, record.line, record.function, record.category);
+        batch += qFormatLogMessage(record.type, context, record.message).toLocal8Bit();
+        batch += '\n';
+        record.message.clear();
+    }
+
+    const std::uint64_t dropped = sink.queue.dropped();
+    if (dropped != sink.reportedDrops) {
+        batch += QByteArray("fmchne: ") + QByteArray::number(dropped - sink.reportedDrops)
+               + " log messages dropped\n";
+        sink.reportedDrops = dropped;
+    }
+
+    if (!batch.isEmpty()) {
+        std::fwrite(batch.constData(), 1, static_cast<std::size_t>(batch.size()), stderr);
+        std::fflush(stderr);
+    }
+}
+
+void flusherLoop(SinkState& sink) {
+    while (!sink.stop.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(sink.wakeMutex);
+            sink.wake.wait_for(lock, FLUSH_INTERVAL);
+        }
+        drain(sink);
+    }
+}
+
+void enqueueMessage(QtMsgType type, const QMessageLogContext& context, const QString& message) {
+    SinkState& sink = *g_sink;
+    sink.queue.push({type, context.category, context.file, context.function, context.line, message});
+
+    if (type == QtFatalMsg) {
+        // Qt aborts as soon as the handler returns, so write it out now
+        drain(sink);
+    } else if (type != QtDebugMsg && type != QtInfoMsg) {
+        // Warnings should not wait for the next interval
+        sink.wake.notify_one();
+    }
+}
+
+} // namespace
+
+AsyncLogSink::AsyncLogSink() {
+    Q_ASSERT(!g_sink);
+    g_sink = new SinkState;
+    g_sink->flusher = std::thread(flusherLoop, std::ref(*g_sink));
+    g_sink->previous = qInstallMessageHandler(enqueueMessage);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    qInstallMessageHandler(g_sink->previous);
+    g_sink->stop.store(true, std::memory_order_release);
+    g_sink->wake.notify_one();
+    g_sink->flusher.join();
+    drain(*g_sink);
+    // Left allocated: a thread that grabbed the handler just before the
+    // switch back may still be enqueueing
+}
+
+std::uint64_t AsyncLogSink::droppedCount() {
+    return g_sink ? g_sink->queue.dropped() : 0;
+}
@@ -0,0 +1,36 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <cstdint>
+
+/*
+ Logging categories. Debug output is off at runtime unless enabled with
+ QT_LOGGING_RULES (e.g. "fmchne.spin.debug=true"), and configuring with
+ -DFMCHNE_DEBUG_LOGGING=OFF compiles every qCDebug out entirely.
+
+ AsyncLogSink takes over Qt's message handler: callers only enqueue the
+ message into a lock-free ring, and a background thread applies the
+ message pattern and writes to stderr in batches. A full ring drops
+ messages (counted and reported) rather than stalling the caller.
+*/
+Q_DECLARE_LOGGING_CATEGORY(lcSpin)
+Q_DECLARE_LOGGING_CATEGORY(lcScreen)
+Q_DECLARE_LOGGING_CATEGORY(lcSave)
+Q_DECLARE_LOGGING_CATEGORY(lcPerf)
+Q_DECLARE_LOGGING_CATEGORY(lcPaytable)
+
+// Installed for the lifetime of the object; create it first in main() so it
+// outlives everything that logs. Only one per process.
+class AsyncLogSink {
+public:
+    AsyncLogSink();
+    ~AsyncLogSink();
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    static std::uint64_t droppedCount();
+};
+
+#endif // LOGGING_H
@@ -0,0 +1,194 @@
+#include "MonteCarlo.h"
+#include "SpinEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Per-worker deque of chunk indices. The owner pops from the front, idle
+// workers steal from the back so they take the work the owner would reach last.
+class ChunkQueue {
+public:
+    void push(std::uint64_t chunk) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_chunks.push_back(chunk);
+    }
+
+    bool pop(std::uint64_t& chunk) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_chunks.empty()) {
+            return false;
+        }
+        chunk = m_chunks.front();
+        m_chunks.pop_front();
+        return true;
+    }
+
+    bool steal(std::uint64_t& chunk) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_chunks.empty()) {
+            return false;
+        }
+        chunk = m_chunks.back();
+        m_chunks.pop_back();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::uint64_t> m_chunks;
+};
+
+GameState freshSession(int startingMoney) {
+    GameState state;
+    state.money = startingMoney;
+    state.maxMoney = startingMoney;
+    return state;
+}
+
+SimulationStats runChunk(const SimulationConfig& config, const SpinRng& stream, std::uint64_t spins) {
+    SpinEngine engine(config.seed);
+    engine.setRng(stream);
+    engine.setPaytable(config.paytable);
+    engine.setReelStrips(config.reels);
+    engine.setState(freshSession(config.startingMoney));
+
+    SimulationStats stats;
+    stats.sessions = 1;
+    std::uint64_t remaining = spins;
+    while (remaining > 0) {
+        if (!engine.canSpin()) {
+            engine.setState(freshSession(config.startingMoney));
+            stats.sessions++;
+        }
+        const BatchResult batch = engine.spin(remaining);
+        if (batch.spins == 0) {
+            break; // Even a fresh session cannot afford a spin
+        }
+        remaining -= batch.spins;
+
+        stats.spins += batch.spins;
+        stats.wins += batch.wins;
+        stats.wagered += batch.wagered;
+        stats.returned += batch.returned;
+        stats.returnedSquares += batch.returnedSquares;
+        for (int i = 0; i < OUTCOME_COUNT; ++i) {
+            stats.outcomes[i] += batch.outcomes[i];
+        }
+    }
+
+    stats.chunks = 1;
+    const double rtp = stats.rtp();
+    stats.chunkRtpSum = rtp;
+    stats.chunkRtpSquares = rtp * rtp;
+    return stats;
+}
+
+} // namespace
+
+void SimulationStats::merge(const SimulationStats& other) {
+    spins += other.spins;
+    wins += other.wins;
+    sessions += other.sessions;
+    wagered += other.wagered;
+    returned += other.returned;
+    returnedSquares += other.returnedSquares;
+    for (int i = 0; i < OUTCOME_COUNT; ++i) {
+        outcomes[i] += other.outcomes[i];
+    }
+    chunks += other.chunks;
+    chunkRtpSum += other.chunkRtpSum;
+    chunkRtpSquares += other.chunkRtpSquares;
+}
+
+double SimulationStats::rtp() const {
+    return wagered > 0 ? static_cast<double>(returned) / static_cast<double>(wagered) : 0.0;
+}
+
+double SimulationStats::hitFrequency() const {
+    return spins > 0 ? static_cast<double>(wins) / static_cast<double>(spins) : 0.0;
+}
+
+double SimulationStats::variance() const {
+    if (spins < 2) {
+        return 0.0;
+    }
+    const double n = static_cast<double>(spins);
+    const double mean = static_cast<double>(returned) / n;
+    return (returnedSquares - n * mean * mean) / (n - 1);
+}
+
+double SimulationStats::confidenceHalfWidth() const {
+    if (chunks < 2) {
+        return 0.0;
+    }
+    const double k = static_cast<double>(chunks);
+    const double mean = chunkRtpSum / k;
+    const double chunkVariance = std::max(0.0, (chunkRtpSquares - k * mean * mean) / (k - 1));
+    return 1.96 * std::sqrt(chunkVariance / k);
+}
+
+SimulationStats runSimulation(const SimulationConfig& config) {
+    const auto start = std::chrono::steady_clock::now();
+    if (config.startingMoney < config.paytable.cost) {
+        return SimulationStats(); // No session could ever spin
+    }
+
+    const std::uint64_t chunkSpins = std::max<std::uint64_t>(1, config.chunkSpins);
+    const std::uint64_t chunkCount = (config.spins + chunkSpins - 1) / chunkSpins;
+    unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, threads);
+
+    // Deal chunks round-robin, stealing evens out whatever imbalance remains.
+    // Chunk n draws from the seed's stream jumped n * 2^128 outputs ahead.
+    std::vector<ChunkQueue> queues(threads);
+    std::vector<SpinRng> streams(chunkCount);
+    SpinRng stream(config.seed);
+    for (std::uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+        queues[chunk % threads].push(chunk);
+        streams[chunk] = stream;
+        stream.jump();
+    }
+
+    // Results are stored per chunk and merged in order so floating point
+    // totals do not depend on which thread ran what
+    std::vector<SimulationStats> results(chunkCount);
+
+    auto worker = [&](unsigned self) {
+        std::uint64_t chunk;
+        for (;;) {
+            bool found = queues[self].pop(chunk);
+            for (unsigned i = 1; !found && i < threads; ++i) {
+                found = queues[(self + i) % threads].steal(chunk);
+            }
+            if (!found) {
+                return;
+            }
+            const std::uint64_t first = chunk * chunkSpins;
+            const std::uint64_t spins = std::min(chunkSpins, config.spins - first);
+            results[chunk] = runChunk(config, streams[chunk], spins);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        pool.emplace_back(worker, i);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    SimulationStats total;
+    for (const SimulationStats& result : results) {
+        total.merge(result);
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
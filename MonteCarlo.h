@@ -0,0 +1,52 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include "ReelStrips.h"
+#include "SlotRules.h"
+
+#include <array>
+#include <cstdint>
+
+struct SimulationConfig {
+    std::uint64_t spins{1'000'000'000};
+    std::uint64_t chunkSpins{1 << 20}; // Unit of work handed to the scheduler
+    unsigned threads{0};               // 0 picks std::thread::hardware_concurrency()
+    std::uint64_t seed{0x5EED};
+    int startingMoney{100};            // Balance a fresh session starts from after going bust
+    Paytable paytable;
+    ReelSet reels{uniformReels()};
+};
+
+// Totals over every simulated spin. Chunk-level moments are kept so the
+// confidence interval can use batch means, since spins within a session
+// are correlated through the balance.
+struct SimulationStats {
+    std::uint64_t spins{0};
+    std::uint64_t wins{0};
+    std::uint64_t sessions{0};
+    std::int64_t wagered{0};
+    std::int64_t returned{0};
+    double returnedSquares{0};
+    std::array<std::uint64_t, OUTCOME_COUNT> outcomes{};
+
+    std::uint64_t chunks{0};
+    double chunkRtpSum{0};
+    double chunkRtpSquares{0};
+
+    double seconds{0};
+
+    void merge(const SimulationStats& other);
+
+    double rtp() const;
+    double hitFrequency() const;
+    double variance() const;         // Per-spin variance of the amount returned, in pence^2
+    double confidenceHalfWidth() const; // 95% half-width on the RTP from chunk batch means
+};
+
+// Runs config.spins spins split into chunks across a pool of worker threads.
+// Every chunk has its own jump-ahead RNG stream of the seed, so the result is
+// identical for any thread count or scheduling order. Nothing is played
+// if the starting balance is below the stake.
+SimulationStats runSimulation(const SimulationConfig& config);
+
+#endif // MONTECARLO_H
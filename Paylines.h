@@ -0,0 +1,46 @@
+#ifndef PAYLINES_H
+#define PAYLINES_H
+
+#include <array>
+#include <cstdint>
+
+/*
+ Payline sets for BasicSpinEngine. A set is a type with a COUNT and, for
+ each line, the row it crosses on every reel (row 0 is the top row). Being
+ compile-time data, the engine unrolls its line evaluation over them.
+*/
+
+template <int ReelCount>
+struct SingleLine {
+    static constexpr int COUNT = 1;
+    static constexpr std::array<std::array<std::uint8_t, ReelCount>, COUNT> ROWS{};
+};
+
+// The usual twenty lines of a five-reel, three-row machine
+struct TwentyLines {
+    static constexpr int COUNT = 20;
+    static constexpr std::array<std::array<std::uint8_t, 5>, COUNT> ROWS{{
+        {1, 1, 1, 1, 1},
+        {0, 0, 0, 0, 0},
+        {2, 2, 2, 2, 2},
+        {0, 1, 2, 1, 0},
+        {2, 1, 0, 1, 2},
+        {0, 0, 1, 0, 0},
+        {2, 2, 1, 2, 2},
+        {1, 2, 2, 2, 1},
+        {1, 0, 0, 0, 1},
+        {1, 0, 1, 0, 1},
+        {1, 2, 1, 2, 1},
+        {0, 1, 0, 1, 0},
+        {2, 1, 2, 1, 2},
+        {1, 1, 0, 1, 1},
+        {1, 1, 2, 1, 1},
+        {0, 1, 1, 1, 0},
+        {2, 1, 1, 1, 2},
+        {0, 2, 0, 2, 0},
+        {2, 0, 2, 0, 2},
+        {0, 2, 2, 2, 0},
+    }};
+};
+
+#endif // PAYLINES_H
@@ -0,0 +1,203 @@
+#include "PaytableFile.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Payouts live in the int16 table entries
+constexpr int MAX_AMOUNT = std::numeric_limits<std::int16_t>::max();
+constexpr int DEBOUNCE_MS = 100;
+
+struct AmountField {
+    const char* key;
+    int Paytable::*member;
+    int minimum;
+};
+
+const AmountField AMOUNT_FIELDS[] = {
+    {"cost", &Paytable::cost, 1},
+    {"jackpot", &Paytable::jackpot, 0},
+    {"threeOfAKind", &Paytable::threeOfAKind, 0},
+    {"pair", &Paytable::pair, 0},
+    {"twoSkullPenalty", &Paytable::twoSkullPenalty, 0},
+};
+
+const char* const WIPE_KEY = "threeSkullsWipe";
+
+bool fail(QString* error, const QString& message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+} // namespace
+
+PaytableReport analysePaytable(const Paytable& paytable, const OutcomeTable& table, const ReelSampler& reels) {
+    PaytableReport report;
+    double mean = 0;
+    double squares = 0;
+    for (int i = 0; i < OUTCOME_TABLE_SIZE; ++i) {
+        const Reels combination = reelsFromIndex(i);
+        double probability = 1;
+        for (int r = 0; r < REEL_COUNT; ++r) {
+            probability *= reels.probability(r, combination[r]);
+        }
+        if (probability == 0) {
+            continue;
+        }
+
+        const OutcomeEntry& entry = table[i];
+        // The stake is taken before the payout is added, so the payout is the
+        // whole amount handed back; a wipe hands back nothing
+        const double returned = entry.payout;
+        mean += probability * returned;
+        squares += probability * returned * returned;
+        report.outcomes[static_cast<int>(entry.outcome)] += probability;
+        if (isWin(entry.outcome)) {
+            report.hitFrequency += probability;
+        }
+    }
+    report.rtp = mean / paytable.cost;
+    report.variance = squares - mean * mean;
+    return report;
+}
+
+CompiledPaytable compilePaytable(const Paytable& paytable, const ReelSampler& reels) {
+    CompiledPaytable compiled;
+    compiled.paytable = paytable;
+    compiled.table = makeOutcomeTable(paytable);
+    compiled.report = analysePaytable(paytable, compiled.table, reels);
+    return compiled;
+}
+
+QJsonObject paytableToJson(const Paytable& paytable) {
+    QJsonObject object;
+    for (const AmountField& field : AMOUNT_FIELDS) {
+        object[field.key] = paytable.*field.member;
+    }
+    object[WIPE_KEY] = paytable.threeSkullsWipe;
+    return object;
+}
+
+bool paytableFromJson(const QJsonObject& object, Paytable& paytable, QString* error) {
+    Paytable parsed;
+    int known = 0;
+    for (const AmountField& field : AMOUNT_FIELDS) {
+        const QJsonValue value = object.value(QLatin1String(field.key));
+        if (value.isUndefined()) {
+            continue;
+        }
+        known++;
+        const double amount = value.toDouble(-1);
+        if (!value.isDouble() || amount != std::floor(amount)) {
+            return fail(error, QString("\"%1\" must be a whole number of pence").arg(field.key));
+        }
+        if (amount < field.minimum || amount > MAX_AMOUNT) {
+            return fail(error, QString("\"%1\" must be between %2 and %3")
+                .arg(field.key).arg(field.minimum).arg(MAX_AMOUNT));
+        }
+        parsed.*field.member = static_cast<int>(amount);
+    }
+
+    const QJsonValue wipe = object.value(QLatin1String(WIPE_KEY));
+    if (!wipe.isUndefined()) {
+        known++;
+        if (!wipe.isBool()) {
+            return fail(error, QString("\"%1\" must be true or false").arg(WIPE_KEY));
+        }
+        parsed.threeSkullsWipe = wipe.toBool();
+    }
+
+    if (known != object.size()) {
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            const QString key = it.key();
+            const bool isAmount = std::any_of(std::begin(AMOUNT_FIELDS), std::end(AMOUNT_FIELDS),
+                [&key](const AmountField& field) { return key == QLatin1String(field.key); });
+            if (!isAmount && key != QLatin1String(WIPE_KEY)) {
+                return fail(error, QString("Unknown key \"%1\"").arg(key));
+            }
+        }
+    }
+
+    paytable = parsed;
+    return true;
+}
+
+bool loadPaytable(const QString& path, CompiledPaytable& compiled, QString* error, const ReelSampler& reels) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(error, QString("Cannot open %1: %2").arg(path, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(error, QString("%1: %2 at offset %3").arg(path, parseError.errorString()).arg(parseError.offset));
+    }
+    if (!document.isObject()) {
+        return fail(error, QString("%1: expected a JSON object").arg(path));
+    }
+
+    Paytable paytable;
+    QString fieldError;
+    if (!paytableFromJson(document.object(), paytable, &fieldError)) {
+        return fail(error, QString("%1: %2").arg(path, fieldError));
+    }
+    compiled = compilePaytable(paytable, reels);
+    return true;
+}
+
+PaytableWatcher::PaytableWatcher(const QString& path, QObject* parent)
+    : QObject(parent)
+    , m_path(path)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(DEBOUNCE_MS);
+    connect(&m_debounce, &QTimer::timeout, this, &PaytableWatcher::reload);
+
+    // Editors that save by replacing the file drop it from the watch list,
+    // so the directory is watched too to pick the new file up
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, &m_debounce, qOverload<>(&QTimer::start));
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        if (!m_watcher.files().contains(m_path) && QFileInfo::exists(m_path)) {
+            m_debounce.start();
+        }
+    });
+    watch();
+}
+
+void PaytableWatcher::watch() {
+    if (QFileInfo::exists(m_path) && !m_watcher.files().contains(m_path)) {
+        m_watcher.addPath(m_path);
+    }
+    const QString directory = QFileInfo(m_path).absolutePath();
+    if (!m_watcher.directories().contains(directory)) {
+        m_watcher.addPath(directory);
+    }
+}
+
+bool PaytableWatcher::reload() {
+    watch();
+
+    auto compiled = std::make_shared<CompiledPaytable>();
+    QString error;
+    if (!loadPaytable(m_path, *compiled, &error)) {
+        emit loadFailed(error);
+        return false;
+    }
+
+    const auto previous = current();
+    if (previous && previous->paytable == compiled->paytable) {
+        return true;
+    }
+    std::atomic_store(&m_current, std::shared_ptr<const CompiledPaytable>(std::move(compiled)));
+    emit paytableChanged();
+    return true;
+}
@@ -0,0 +1,92 @@
+#ifndef PAYTABLEFILE_H
+#define PAYTABLEFILE_H
+
+#include "ReelStrips.h"
+#include "SlotRules.h"
+
+#include <QFileSystemWatcher>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <array>
+#include <memory>
+
+/*
+ Paytables loaded from a JSON file instead of being compiled in:
+
+   {
+     "cost": 20,
+     "jackpot": 500,
+     "threeOfAKind": 100,
+     "pair": 50,
+     "twoSkullPenalty": 100,
+     "threeSkullsWipe": true
+   }
+
+ Amounts are in pence. Missing keys keep the original machine's value, but
+ unknown keys, non-integers and out-of-range amounts reject the whole file,
+ so a typo never quietly turns into a default. A loaded paytable is
+ compiled straight into the per-combination outcome table the engine spins
+ against (216 four-byte entries) and analysed exactly on the reels it will
+ be played with.
+*/
+
+// Exact figures from enumerating every reel combination with its probability.
+// Per spin and independent of the balance: the floor at zero and the part of
+// the balance a wipe takes beyond the stake are not counted.
+struct PaytableReport {
+    double rtp{0};          // Expected return per pence staked
+    double hitFrequency{0};
+    double variance{0};     // Of the amount returned per spin, in pence^2
+    std::array<double, OUTCOME_COUNT> outcomes{}; // Probability of each outcome
+};
+
+struct CompiledPaytable {
+    Paytable paytable;
+    OutcomeTable table{};
+    PaytableReport report;
+};
+
+PaytableReport analysePaytable(const Paytable& paytable, const OutcomeTable& table,
+                               const ReelSampler& reels = ReelSampler());
+CompiledPaytable compilePaytable(const Paytable& paytable, const ReelSampler& reels = ReelSampler());
+
+QJsonObject paytableToJson(const Paytable& paytable);
+bool paytableFromJson(const QJsonObject& object, Paytable& paytable, QString* error = nullptr);
+// Reads, validates and compiles; leaves compiled untouched on failure
+bool loadPaytable(const QString& path, CompiledPaytable& compiled, QString* error = nullptr,
+                  const ReelSampler& reels = ReelSampler());
+
+// Keeps a compiled paytable in step with its file. A change is debounced
+// (editors often write in several steps), recompiled off to the side and
+// only then swapped in with a single atomic pointer store, so readers see
+// the old table or the new one, never a mix, and a broken edit keeps the
+// last good table.
+class PaytableWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PaytableWatcher(const QString& path, QObject* parent = nullptr);
+
+    const QString& path() const { return m_path; }
+    // Null until the file has loaded successfully once; safe from any thread
+    std::shared_ptr<const CompiledPaytable> current() const { return std::atomic_load(&m_current); }
+
+    // Loads the file now; false (and loadFailed) if it did not load
+    bool reload();
+
+signals:
+    void paytableChanged();
+    void loadFailed(const QString& error);
+
+private:
+    void watch();
+
+    QString m_path;
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+    std::shared_ptr<const CompiledPaytable> m_current;
+};
+
+#endif // PAYTABLEFILE_H
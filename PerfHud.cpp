@@ -0,0 +1,134 @@
+#include "PerfHud.h"
+
+#include <QAbstractAnimation>
+#include <QPainter>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+double milliseconds(std::uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+} // namespace
+
+PerfHud::PerfHud(QWidget* parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    QFont mono(QStringLiteral("monospace"));
+    mono.setStyleHint(QFont::TypeWriter);
+    mono.setPixelSize(13);
+    setFont(mono);
+
+    m_refresh.setInterval(REFRESH_MS);
+    connect(&m_refresh, &QTimer::timeout, this, &PerfHud::refresh);
+    hide();
+}
+
+void PerfHud::toggle() {
+    if (isVisible()) {
+        // Stop sampling, then take what is still queued so nothing stale waits for the next show
+        m_refresh.stop();
+        PerfMonitor::instance().setActive(false);
+        refresh();
+        hide();
+        return;
+    }
+
+    PerfMonitor::instance().setActive(true);
+    refresh();
+    m_refresh.start();
+    raise();
+    show();
+}
+
+void PerfHud::refresh() {
+    PerfMonitor& monitor = PerfMonitor::instance();
+
+    std::uint32_t sample = 0;
+    while (monitor.frameTimes().pop(sample)) {
+        m_frames[m_frameNext] = sample;
+        m_frameNext = (m_frameNext + 1) % FRAME_WINDOW;
+        m_frameCount = std::min(m_frameCount + 1, FRAME_WINDOW);
+    }
+    while (monitor.stalls().pop(sample)) {
+        m_stallCount++;
+        m_stallTotalNs += sample;
+        m_stallMaxNs = std::max(m_stallMaxNs, sample);
+    }
+    PerfMonitor::PaintSample paint{};
+    while (monitor.paints().pop(paint)) {
+        PaintStats& stats = m_paints[paint.className];
+        stats.count++;
+        stats.totalNs += paint.nanoseconds;
+        stats.maxNs = std::max(stats.maxNs, paint.nanoseconds);
+    }
+
+    std::vector<std::uint32_t> frames(m_frames.begin(), m_frames.begin() + m_frameCount);
+    std::sort(frames.begin(), frames.end());
+    const auto percentile = [&frames](double quantile) {
+        return frames.empty() ? 0.0 : milliseconds(frames[static_cast<std::size_t>(quantile * (frames.size() - 1))]);
+    };
+
+    // Everything parented under the window, which is what the game creates
+    const QWidget* root = window();
+    const QList<QObject*> objects = root->findChildren<QObject*>();
+    int animations = 0;
+    int running = 0;
+    for (const QObject* object : objects) {
+        if (const auto* animation = qobject_cast<const QAbstractAnimation*>(object)) {
+            animations++;
+            running += animation->state() == QAbstractAnimation::Running ? 1 : 0;
+        }
+    }
+
+    QString text = QString(
+        "Frame   p50 %1 ms  p95 %2 ms  p99 %3 ms  (%4 frames)\n"
+        "Stalls  %5 over %6 ms, %7 ms total, worst %8 ms\n"
+        "Live    %9 QObjects, %10 animations (%11 running)\n"
+        "Paint   per call avg / max, calls\n")
+        .arg(percentile(0.50), 0, 'f', 2)
+        .arg(percentile(0.95), 0, 'f', 2)
+        .arg(percentile(0.99), 0, 'f', 2)
+        .arg(m_frameCount)
+        .arg(m_stallCount)
+        .arg(PerfMonitor::STALL_THRESHOLD_NS / 1'000'000)
+        .arg(milliseconds(m_stallTotalNs), 0, 'f', 1)
+        .arg(milliseconds(m_stallMaxNs), 0, 'f', 1)
+        .arg(objects.size() + 1)
+        .arg(animations)
+        .arg(running);
+
+    // Heaviest widget classes first
+    std::vector<std::pair<const char*, PaintStats>> paints(m_paints.cbegin(), m_paints.cend());
+    std::sort(paints.begin(), paints.end(), [](const auto& a, const auto& b) {
+        return a.second.totalNs > b.second.totalNs;
+    });
+    for (const auto& [className, stats] : paints) {
+        text += QString("  %1 %2 / %3 ms, %4\n")
+            .arg(QLatin1String(className), -18)
+            .arg(milliseconds(stats.totalNs / stats.count), 0, 'f', 3)
+            .arg(milliseconds(stats.maxNs), 0, 'f', 3)
+            .arg(stats.count);
+    }
+    const std::uint64_t dropped = monitor.frameTimes().dropped() + monitor.stalls().dropped() + monitor.paints().dropped();
+    if (dropped > 0) {
+        text += QString("Dropped %1 samples\n").arg(dropped);
+    }
+
+    m_text = text.trimmed();
+    resize(fontMetrics().boundingRect(QRect(), Qt::AlignLeft, m_text).size() + QSize(16, 16));
+    update();
+}
+
+void PerfHud::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0, 0, 0, 180));
+    painter.setPen(QColor("#7CFC00"));
+    painter.setFont(font());
+    painter.drawText(rect().adjusted(8, 8, -8, -8), Qt::AlignLeft | Qt::AlignTop, m_text);
+}
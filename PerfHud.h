@@ -0,0 +1,57 @@
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include "PerfMonitor.h"
+
+#include <QHash>
+#include <QTimer>
+#include <QWidget>
+#include <array>
+#include <cstdint>
+
+/*
+ Overlay with what PerfMonitor measured: frame time percentiles over the
+ last FRAME_WINDOW frames, event-loop stalls, paint time per widget class,
+ and the live QObject and animation counts under the window. Stall and
+ paint figures accumulate over the time the HUD has been shown. It drains the
+ monitor's rings and repaints only on its 250 ms refresh, so it adds next
+ to nothing to the frames it measures.
+*/
+class PerfHud : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit PerfHud(QWidget* parent);
+
+    void toggle();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    struct PaintStats {
+        std::uint64_t count{0};
+        std::uint64_t totalNs{0};
+        std::uint32_t maxNs{0};
+    };
+
+    static constexpr int FRAME_WINDOW = 512;
+    static constexpr int REFRESH_MS = 250;
+
+    void refresh();
+
+    QTimer m_refresh;
+    QString m_text;
+
+    std::array<std::uint32_t, FRAME_WINDOW> m_frames{};
+    int m_frameCount{0};
+    int m_frameNext{0};
+
+    std::uint64_t m_stallCount{0};
+    std::uint64_t m_stallTotalNs{0};
+    std::uint32_t m_stallMaxNs{0};
+
+    QHash<const char*, PaintStats> m_paints; // Keyed by className pointer, one per class
+};
+
+#endif // PERFHUD_H
@@ -0,0 +1,69 @@
+#include "PerfMonitor.h"
+
+#include <QEvent>
+#include <QWidget>
+#include <QWindow>
+
+PerfMonitor& PerfMonitor::instance() {
+    static PerfMonitor monitor;
+    return monitor;
+}
+
+PerfMonitor::PerfMonitor() {
+    m_clock.start();
+}
+
+void PerfMonitor::setActive(bool active) {
+    m_active = active;
+    m_lastFrameNs = -1;
+}
+
+void PerfMonitor::frame(qint64 nowNs) {
+    if (m_lastFrameNs >= 0) {
+        const qint64 interval = nowNs - m_lastFrameNs;
+        if (interval < IDLE_GAP_NS) {
+            m_frameTimes.push(static_cast<std::uint32_t>(interval));
+        }
+    }
+    m_lastFrameNs = nowNs;
+}
+
+ProfilingApplication::ProfilingApplication(int& argc, char** argv)
+    : QApplication(argc, argv)
+{
+}
+
+bool ProfilingApplication::notify(QObject* receiver, QEvent* event) {
+    PerfMonitor& monitor = PerfMonitor::instance();
+    if (!monitor.isActive()) {
+        return QApplication::notify(receiver, event);
+    }
+
+    const QEvent::Type type = event->type();
+    // A frame is one update request to a top-level window, widget or QWindow;
+    // one forwarded from the QWindow to its widget is the same frame
+    const bool frame = type == QEvent::UpdateRequest && !m_inFrame
+        && (receiver->isWindowType()
+            || (receiver->isWidgetType() && static_cast<QWidget*>(receiver)->isWindow()));
+    if (frame) {
+        monitor.frame(monitor.now());
+        m_inFrame = true;
+    }
+
+    const qint64 start = monitor.now();
+    m_depth++;
+    const bool handled = QApplication::notify(receiver, event);
+    m_depth--;
+    const qint64 elapsed = monitor.now() - start;
+    if (frame) {
+        m_inFrame = false;
+    }
+
+    if (type == QEvent::Paint && receiver->isWidgetType()) {
+        monitor.paint(receiver->metaObject()->className(), elapsed);
+    }
+    if (m_depth == 0 && elapsed > PerfMonitor::STALL_THRESHOLD_NS) {
+        monitor.stall(elapsed);
+    }
+    return handled;
+}
@@ -0,0 +1,73 @@
+#ifndef PERFMONITOR_H
+#define PERFMONITOR_H
+
+#include "RingBuffer.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <cstdint>
+
+/*
+ Frame and event-loop timing for the performance HUD.
+
+ ProfilingApplication times event delivery in notify(): the gap between
+ consecutive frame requests gives frame times, an outermost event that
+ takes longer than a frame counts as an event-loop stall, and every Paint
+ event is attributed to the receiving widget's class. Samples go into
+ lock-free rings that the HUD drains a few times a second. While the HUD
+ is hidden, monitoring is off and notify() costs one branch.
+*/
+class PerfMonitor {
+public:
+    struct PaintSample {
+        const char* className; // From the static metaobject, so it outlives the widget
+        std::uint32_t nanoseconds;
+    };
+
+    static constexpr qint64 STALL_THRESHOLD_NS = 16'000'000;
+    // Longer frame gaps are idle time, not slow frames. Well under the HUD's
+    // 250 ms refresh, whose own repaint is the only frame an idle game asks for;
+    // anything slower than this still shows up as a stall.
+    static constexpr qint64 IDLE_GAP_NS = 100'000'000;
+
+    static PerfMonitor& instance();
+
+    bool isActive() const { return m_active; }
+    void setActive(bool active);
+
+    // Producer side, called from ProfilingApplication on the GUI thread
+    void frame(qint64 nowNs);
+    void stall(qint64 nanoseconds) { m_stalls.push(static_cast<std::uint32_t>(qMin<qint64>(nanoseconds, UINT32_MAX))); }
+    void paint(const char* className, qint64 nanoseconds) {
+        m_paints.push({className, static_cast<std::uint32_t>(qMin<qint64>(nanoseconds, UINT32_MAX))});
+    }
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+
+    // Consumer side
+    RingBuffer<std::uint32_t, 1024>& frameTimes() { return m_frameTimes; }
+    RingBuffer<std::uint32_t, 256>& stalls() { return m_stalls; }
+    RingBuffer<PaintSample, 4096>& paints() { return m_paints; }
+
+private:
+    PerfMonitor();
+
+    bool m_active{false};
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameNs{-1};
+    RingBuffer<std::uint32_t, 1024> m_frameTimes;
+    RingBuffer<std::uint32_t, 256> m_stalls;
+    RingBuffer<PaintSample, 4096> m_paints;
+};
+
+class ProfilingApplication : public QApplication {
+public:
+    ProfilingApplication(int& argc, char** argv);
+
+    bool notify(QObject* receiver, QEvent* event) override;
+
+private:
+    int m_depth{0}; // Nested sends are part of their outer event's time
+    bool m_inFrame{false};
+};
+
+#endif // PERFMONITOR_H
@@ -0,0 +1,115 @@
+#include "ReelStrips.h"
+
+#include <cmath>
+#include <numeric>
+
+ReelStrip ReelStrip::uniform() {
+    ReelStrip strip;
+    for (int i = 0; i < SYMBOL_COUNT; ++i) {
+        strip.stops.push_back(static_cast<Symbol>(i));
+    }
+    return strip;
+}
+
+ReelStrip ReelStrip::weighted(const std::array<std::uint32_t, SYMBOL_COUNT>& symbolWeights) {
+    ReelStrip strip = uniform();
+    strip.weights.assign(symbolWeights.begin(), symbolWeights.end());
+    return strip;
+}
+
+bool validateStrip(const ReelStrip& strip, int reelNumber, std::string* error) {
+    auto fail = [error](const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    const std::string reel = "Reel " + std::to_string(reelNumber);
+    if (strip.stops.empty()) {
+        return fail(reel + " has no stops");
+    }
+    if (strip.stops.size() > 0xFFFF) {
+        return fail(reel + " has more than 65535 stops");
+    }
+    for (Symbol symbol : strip.stops) {
+        if (static_cast<int>(symbol) >= SYMBOL_COUNT) {
+            return fail(reel + " has an unknown symbol");
+        }
+    }
+    if (!strip.weights.empty()) {
+        if (strip.weights.size() != strip.stops.size()) {
+            return fail(reel + " needs one weight per stop");
+        }
+        const std::uint64_t total = std::accumulate(strip.weights.begin(), strip.weights.end(), std::uint64_t{0});
+        if (total == 0) {
+            return fail(reel + " has a total weight of zero");
+        }
+    }
+    return true;
+}
+
+AliasTable::AliasTable(const std::vector<double>& weights)
+    : m_columns(weights.size())
+{
+    const std::size_t n = weights.size();
+    if (n == 0) {
+        return;
+    }
+    const std::uint32_t range = static_cast<std::uint32_t>(n);
+    m_threshold = static_cast<std::uint32_t>(-range) % range;
+
+    // Vose: scale so the average column is 1, then pair each underfull
+    // column with an overfull one that donates the remainder
+    const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    std::vector<double> scaled(n);
+    std::vector<std::uint32_t> small;
+    std::vector<std::uint32_t> large;
+    for (std::uint32_t i = 0; i < range; ++i) {
+        scaled[i] = weights[i] * static_cast<double>(n) / total;
+        m_columns[i] = Column{0xFFFFFFFFu, i};
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        const std::uint32_t less = small.back();
+        small.pop_back();
+        const std::uint32_t more = large.back();
+        large.pop_back();
+
+        m_columns[less].keep = static_cast<std::uint32_t>(std::ldexp(scaled[less], 32));
+        m_columns[less].alias = more;
+
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+        (scaled[more] < 1.0 ? small : large).push_back(more);
+    }
+
+    // Whatever is left is full up to rounding error and aliases to itself
+    for (std::uint32_t i : small) {
+        m_columns[i] = Column{0xFFFFFFFFu, i};
+    }
+    for (std::uint32_t i : large) {
+        m_columns[i] = Column{0xFFFFFFFFu, i};
+    }
+}
+
+CompiledStrip compileStrip(const ReelStrip& strip) {
+    CompiledStrip compiled;
+    std::vector<double> weights(strip.stops.size(), 1.0);
+    bool equalWeights = true;
+    if (!strip.weights.empty()) {
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            weights[i] = static_cast<double>(strip.weights[i]);
+            equalWeights = equalWeights && strip.weights[i] == strip.weights[0];
+        }
+    }
+    compiled.table = AliasTable(weights);
+
+    const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        compiled.probabilities[static_cast<int>(strip.stops[i])] += weights[i] / total;
+    }
+
+    compiled.uniform = equalWeights && strip.stops == ReelStrip::uniform().stops;
+    return compiled;
+}
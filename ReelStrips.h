@@ -0,0 +1,139 @@
+#ifndef REELSTRIPS_H
+#define REELSTRIPS_H
+
+#include "Rng.h"
+#include "SlotRules.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One physical reel: the symbols at each stop, optionally with a weight per
+// stop. Without weights every stop is equally likely.
+struct ReelStrip {
+    std::vector<Symbol> stops;
+    std::vector<std::uint32_t> weights;
+
+    // Each symbol once, equally likely: the original machine
+    static ReelStrip uniform();
+    // Each symbol once, weighted by the given per-symbol weights
+    static ReelStrip weighted(const std::array<std::uint32_t, SYMBOL_COUNT>& symbolWeights);
+};
+
+template <int ReelCount>
+using BasicReelSet = std::array<ReelStrip, ReelCount>;
+// Stop index on each reel strip; the top visible row sits on the stop
+template <int ReelCount>
+using BasicReelStops = std::array<std::uint16_t, ReelCount>;
+
+using ReelSet = BasicReelSet<REEL_COUNT>;
+using ReelStops = BasicReelStops<REEL_COUNT>;
+
+template <int ReelCount = REEL_COUNT>
+BasicReelSet<ReelCount> uniformReels() {
+    BasicReelSet<ReelCount> reels;
+    reels.fill(ReelStrip::uniform());
+    return reels;
+}
+
+// reelNumber only labels the error message
+bool validateStrip(const ReelStrip& strip, int reelNumber, std::string* error = nullptr);
+
+template <std::size_t ReelCount>
+bool validateReels(const std::array<ReelStrip, ReelCount>& reels, std::string* error = nullptr) {
+    for (std::size_t r = 0; r < ReelCount; ++r) {
+        if (!validateStrip(reels[r], static_cast<int>(r) + 1, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Walker/Vose alias table: draws an index with probability proportional to
+// its weight using one 64-bit output, whatever the number of entries. The
+// high half picks a column (Lemire), the low half flips that column's coin.
+class AliasTable {
+public:
+    AliasTable() = default;
+    explicit AliasTable(const std::vector<double>& weights);
+
+    std::size_t size() const { return m_columns.size(); }
+
+    template <typename Generator>
+    std::uint32_t operator()(Generator& gen) const {
+        const std::uint32_t range = static_cast<std::uint32_t>(m_columns.size());
+        std::uint64_t x = gen();
+        std::uint64_t m = (x >> 32) * range;
+        while (static_cast<std::uint32_t>(m) < m_threshold) {
+            x = gen();
+            m = (x >> 32) * range;
+        }
+        const Column& column = m_columns[m >> 32];
+        return static_cast<std::uint32_t>(x) < column.keep ? static_cast<std::uint32_t>(m >> 32) : column.alias;
+    }
+
+private:
+    struct Column {
+        std::uint32_t keep;  // Stay in this column if the coin is below this, out of 2^32
+        std::uint32_t alias;
+    };
+
+    std::vector<Column> m_columns;
+    std::uint32_t m_threshold{0}; // Lemire rejection threshold for the column draw
+};
+
+// One strip compiled for sampling, see BasicReelSampler
+struct CompiledStrip {
+    AliasTable table;
+    std::array<double, SYMBOL_COUNT> probabilities{};
+    bool uniform{true}; // Each symbol once, in order, equally weighted
+};
+
+CompiledStrip compileStrip(const ReelStrip& strip);
+
+// Reel set compiled into alias tables. Built once per configuration change,
+// after which a spin costs one O(1) draw per reel.
+template <int ReelCount>
+class BasicReelSampler {
+public:
+    BasicReelSampler() : BasicReelSampler(uniformReels<ReelCount>()) {}
+
+    explicit BasicReelSampler(const BasicReelSet<ReelCount>& reels)
+        : m_reels(reels)
+    {
+        for (int r = 0; r < ReelCount; ++r) {
+            CompiledStrip compiled = compileStrip(m_reels[r]);
+            m_tables[r] = std::move(compiled.table);
+            m_probabilities[r] = compiled.probabilities;
+            m_uniform = m_uniform && compiled.uniform;
+        }
+    }
+
+    const BasicReelSet<ReelCount>& reels() const { return m_reels; }
+    bool isUniform() const { return m_uniform; }
+    double probability(int reel, Symbol symbol) const { return m_probabilities[reel][static_cast<int>(symbol)]; }
+
+    // Symbol shown on a reel the given number of rows below its stop
+    Symbol symbolAt(int reel, std::uint16_t stop, int row = 0) const {
+        const std::vector<Symbol>& stops = m_reels[reel].stops;
+        return stops[(stop + row) % stops.size()];
+    }
+
+    template <typename Generator>
+    void roll(Generator& gen, BasicReelStops<ReelCount>& stops) const {
+        for (int r = 0; r < ReelCount; ++r) {
+            stops[r] = static_cast<std::uint16_t>(m_tables[r](gen));
+        }
+    }
+
+private:
+    BasicReelSet<ReelCount> m_reels;
+    std::array<AliasTable, ReelCount> m_tables;
+    std::array<std::array<double, SYMBOL_COUNT>, ReelCount> m_probabilities{};
+    bool m_uniform{true};
+};
+
+using ReelSampler = BasicReelSampler<REEL_COUNT>;
+
+#endif // REELSTRIPS_H
@@ -0,0 +1,233 @@
+#include "ReelWidget.h"
+
+#include <QEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPaintEvent>
+#include <QWindow>
+#include <cmath>
+
+namespace {
+
+constexpr int BLANK_GLYPH = SYMBOL_COUNT;
+constexpr int GLYPH_COUNT = SYMBOL_COUNT + 1;
+
+constexpr int SPIN_MS = 900;         // Left reel
+constexpr int STAGGER_MS = 350;      // Each further reel runs this much longer
+constexpr int MIN_REVOLUTIONS = 2;
+
+const QColor GOLD("#FFD700");
+const QColor WINDOW_COLOR("#000000");
+const QColor REEL_COLOR("#1a1a1a");
+
+double easeOutCubic(double t) {
+    const double inverse = 1 - t;
+    return 1 - inverse * inverse * inverse;
+}
+
+} // namespace
+
+ReelWidget::ReelWidget(int reelWidth, int reelHeight, int spacing, QWidget *parent)
+    : QWidget(parent)
+    , m_reelWidth(reelWidth)
+    , m_reelHeight(reelHeight)
+    , m_spacing(spacing)
+    , m_strips(uniformReels())
+{
+    setFixedSize(reelWidth * REEL_COUNT + spacing * (REEL_COUNT - 1), reelHeight);
+
+    QFont glyphFont = font();
+    glyphFont.setPixelSize(48);
+    setFont(glyphFont);
+}
+
+void ReelWidget::setStrips(const ReelSet &strips) {
+    m_strips = strips;
+    clear();
+}
+
+void ReelWidget::clear() {
+    m_spinning = false;
+    m_blank = true;
+    for (Reel &reel : m_reels) {
+        reel = Reel();
+    }
+    update();
+}
+
+void ReelWidget::setStops(const ReelStops &stops) {
+    m_spinning = false;
+    m_blank = false;
+    for (int i = 0; i < REEL_COUNT; ++i) {
+        m_reels[i].position = m_reels[i].target = stops[i];
+    }
+    update();
+}
+
+void ReelWidget::spinTo(const ReelStops &stops) {
+    for (int i = 0; i < REEL_COUNT; ++i) {
+        Reel &reel = m_reels[i];
+        const double length = static_cast<double>(m_strips[i].stops.size());
+        // Keep the position small so it never loses precision over a long session
+        reel.start = std::fmod(m_blank ? 0.0 : reel.position, length);
+        reel.position = reel.start;
+
+        const double minimum = reel.start + length * (MIN_REVOLUTIONS + i);
+        reel.target = stops[i] + length * std::ceil((minimum - stops[i]) / length);
+        reel.durationMs = SPIN_MS + STAGGER_MS * i;
+    }
+
+    m_blank = false;
+    m_spinning = true;
+    m_clock.start();
+    requestFrame();
+    update();
+}
+
+QRect ReelWidget::reelRect(int reel) const {
+    return QRect(reel * (m_reelWidth + m_spacing), 0, m_reelWidth, m_reelHeight);
+}
+
+void ReelWidget::requestFrame() {
+    QWindow *handle = window()->windowHandle();
+    if (!handle) {
+        // Not on screen yet, nothing to pace against: land immediately
+        for (Reel &reel : m_reels) {
+            reel.position = reel.target;
+        }
+        m_spinning = false;
+        emit spinFinished();
+        return;
+    }
+    // Watching the top-level window's frame requests. Reinstalling would be
+    // harmless but reshuffles the filter list, which allocates on every spin
+    if (handle != m_frameSource) {
+        handle->installEventFilter(this);
+        m_frameSource = handle;
+    }
+    handle->requestUpdate();
+}
+
+bool ReelWidget::eventFilter(QObject *watched, QEvent *event) {
+    // Never consumed: the window still has to flush its own backing store
+    if (event->type() == QEvent::UpdateRequest && m_spinning
+        && watched == window()->windowHandle()) {
+        advance();
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void ReelWidget::advance() {
+    const qint64 elapsed = m_clock.elapsed();
+    bool running = false;
+
+    for (int i = 0; i < REEL_COUNT; ++i) {
+        Reel &reel = m_reels[i];
+        const double t = qMin(1.0, static_cast<double>(elapsed) / reel.durationMs);
+        const double position = reel.start + (reel.target - reel.start) * easeOutCubic(t);
+        if (position != reel.position) {
+            reel.position = position;
+            update(reelRect(i));
+        }
+        running = running || t < 1;
+    }
+
+    if (running) {
+        window()->windowHandle()->requestUpdate();
+    } else {
+        m_spinning = false;
+        emit spinFinished();
+    }
+}
+
+void ReelWidget::changeEvent(QEvent *event) {
+    if (event->type() == QEvent::FontChange) {
+        m_atlas = QPixmap();
+    }
+    QWidget::changeEvent(event);
+}
+
+void ReelWidget::ensureAtlas() {
+    const qreal dpr = devicePixelRatioF();
+    if (!m_atlas.isNull() && m_atlasDpr == dpr && m_atlasFont == font()) {
+        return;
+    }
+
+    m_atlas = QPixmap(QSize(m_reelWidth * GLYPH_COUNT, m_reelHeight) * dpr);
+    m_atlas.setDevicePixelRatio(dpr);
+    m_atlas.fill(Qt::transparent);
+
+    QPainter painter(&m_atlas);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font());
+    painter.setPen(GOLD);
+    for (int glyph = 0; glyph < GLYPH_COUNT; ++glyph) {
+        const QString text = glyph == BLANK_GLYPH
+            ? QStringLiteral("?")
+            : QString::fromUtf8(symbolEmoji(static_cast<Symbol>(glyph)));
+        painter.drawText(QRect(glyph * m_reelWidth, 0, m_reelWidth, m_reelHeight),
+                         Qt::AlignCenter, text);
+    }
+
+    m_atlasDpr = dpr;
+    m_atlasFont = font();
+}
+
+void ReelWidget::drawGlyph(QPainter &painter, int glyph, const QRect &target) const {
+    // Source rects are in device pixels
+    const QRectF source(glyph * m_reelWidth * m_atlasDpr, 0, m_reelWidth * m_atlasDpr, m_reelHeight * m_atlasDpr);
+    painter.drawPixmap(target, m_atlas, source);
+}
+
+void ReelWidget::paintEvent(QPaintEvent *event) {
+    ensureAtlas();
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // Window behind the reels, only where it shows through the gaps
+    QRegion reelArea;
+    for (int i = 0; i < REEL_COUNT; ++i) {
+        reelArea += reelRect(i);
+    }
+    if (!event->region().subtracted(reelArea).isEmpty()) {
+        painter.setPen(QPen(GOLD, 3));
+        painter.setBrush(WINDOW_COLOR);
+        painter.drawRoundedRect(QRectF(rect()).adjusted(1.5, 1.5, -1.5, -1.5), 10, 10);
+    }
+
+    for (int i = 0; i < REEL_COUNT; ++i) {
+        const QRect area = reelRect(i);
+        if (!event->region().intersects(area)) {
+            continue;
+        }
+
+        QPainterPath shape;
+        shape.addRoundedRect(QRectF(area).adjusted(1, 1, -1, -1), 5, 5);
+        painter.setPen(Qt::NoPen);
+        painter.fillPath(shape, REEL_COLOR);
+
+        painter.save();
+        painter.setClipPath(shape);
+        if (m_blank) {
+            drawGlyph(painter, BLANK_GLYPH, area);
+        } else {
+            // The stop at floor(position) and the one scrolling in above it
+            const std::vector<Symbol> &stops = m_strips[i].stops;
+            const int length = static_cast<int>(stops.size());
+            const double whole = std::floor(m_reels[i].position);
+            const int offset = static_cast<int>((m_reels[i].position - whole) * m_reelHeight);
+            const int current = static_cast<int>(std::fmod(whole, length));
+            const int next = (current + 1) % length;
+            drawGlyph(painter, static_cast<int>(stops[current]), area.translated(0, offset));
+            if (offset != 0) {
+                drawGlyph(painter, static_cast<int>(stops[next]), area.translated(0, offset - m_reelHeight));
+            }
+        }
+        painter.restore();
+
+        painter.setPen(QPen(GOLD, 2));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPath(shape);
+    }
+}
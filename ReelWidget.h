@@ -0,0 +1,79 @@
+#ifndef REELWIDGET_H
+#define REELWIDGET_H
+
+#include "ReelStrips.h"
+
+#include <QElapsedTimer>
+#include <QFont>
+#include <QPixmap>
+#include <QPointer>
+#include <QWindow>
+#include <QWidget>
+#include <array>
+
+/*
+ The machine's reels, drawn as real scrolling strips.
+
+ Every glyph (the six symbols plus the "?" shown before the first spin) is
+ rasterized once into an atlas for the current device pixel ratio and
+ font, so a frame is only a few pixmap blits per reel. Frames are driven by
+ QWindow::requestUpdate(), which the platform paces to the display refresh,
+ and positions come from elapsed time rather than frame counts. Only reels
+ that actually moved are repainted.
+*/
+class ReelWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    ReelWidget(int reelWidth, int reelHeight, int spacing, QWidget *parent = nullptr);
+
+    void setStrips(const ReelSet &strips);
+    // Back to "?" on every reel, no animation
+    void clear();
+    // Jumps straight to the given stops, no animation
+    void setStops(const ReelStops &stops);
+    // Scrolls each reel to its stop, decelerating, the left reel stopping first.
+    // A spin that starts while one is still running continues from where it is.
+    void spinTo(const ReelStops &stops);
+    bool isSpinning() const { return m_spinning; }
+
+signals:
+    void spinFinished();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct Reel {
+        double position = 0; // In stops; stop n sits centred when position == n
+        double start = 0;
+        double target = 0;
+        int durationMs = 0;
+    };
+
+    QRect reelRect(int reel) const;
+    void ensureAtlas();
+    void advance();
+    void requestFrame();
+    void drawGlyph(QPainter &painter, int glyph, const QRect &target) const;
+
+    int m_reelWidth;
+    int m_reelHeight;
+    int m_spacing;
+
+    ReelSet m_strips;
+    std::array<Reel, REEL_COUNT> m_reels{};
+    bool m_blank = true;
+    bool m_spinning = false;
+    QElapsedTimer m_clock;
+    QPointer<QWindow> m_frameSource;
+
+    // One cell per symbol, then "?"
+    QPixmap m_atlas;
+    qreal m_atlasDpr = 0;
+    QFont m_atlasFont;
+};
+
+#endif // REELWIDGET_H
@@ -0,0 +1,192 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// Small, fast generators for the spin path. Anything with a 64-bit
+// result_type and operator() can be used with BoundedSampler; SpinEngine
+// picks its generator through the SpinRng alias in SpinEngine.h.
+
+// Used to expand a single 64-bit seed into generator state
+class SplitMix64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit constexpr SplitMix64(std::uint64_t seed) : m_state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+// xoshiro256** by Blackman and Vigna: 32 bytes of state, period 2^256 - 1.
+// jump() advances 2^128 outputs, giving 2^128 non-overlapping streams.
+class Xoshiro256StarStar {
+public:
+    using result_type = std::uint64_t;
+
+    explicit constexpr Xoshiro256StarStar(std::uint64_t seed = 0) {
+        SplitMix64 mix(seed);
+        for (std::uint64_t& word : m_s) {
+            word = mix();
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() {
+        const std::uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+        const std::uint64_t t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = rotl(m_s[3], 45);
+        return result;
+    }
+
+    // Equivalent to count calls to operator(), but logarithmic in count for
+    // long runs: x^count is reduced modulo the characteristic polynomial and
+    // applied the same way as the jump polynomials, a fraction of a
+    // millisecond however far the generator has to go
+    constexpr void discard(std::uint64_t count) {
+        if (count < DIRECT_DISCARD) {
+            for (; count > 0; --count) {
+                (*this)();
+            }
+            return;
+        }
+        applyJump(powerOfX(count));
+    }
+
+    // Equivalent to 2^128 calls to operator()
+    constexpr void jump() {
+        applyJump({0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                   0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull});
+    }
+
+    // Equivalent to 2^192 calls to operator()
+    constexpr void longJump() {
+        applyJump({0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull,
+                   0x77710069854EE241ull, 0x39109BB02ACBE635ull});
+    }
+
+    friend bool operator==(const Xoshiro256StarStar& a, const Xoshiro256StarStar& b) {
+        return a.m_s == b.m_s;
+    }
+
+private:
+    using Polynomial = std::array<std::uint64_t, 4>; // Over GF(2), bit i is the x^i term
+
+    // Below this stepping is cheaper than the polynomial arithmetic
+    static constexpr std::uint64_t DIRECT_DISCARD = 1 << 17;
+
+    // Characteristic polynomial of the state transition, less its x^256 term.
+    // Reducing x^(2^128) and x^(2^192) by it gives jump() and longJump().
+    static constexpr Polynomial CHARACTERISTIC{0x9D116F2BB0F0F001ull, 0x0280002BCEFD1A5Eull,
+                                               0x04B4EDCF26259F85ull, 0x0003C03C3F3ECB19ull};
+
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // a * x mod the characteristic polynomial
+    static constexpr void timesX(Polynomial& a) {
+        const bool overflow = (a[3] >> 63) != 0;
+        for (int i = 3; i > 0; --i) {
+            a[i] = (a[i] << 1) | (a[i - 1] >> 63);
+        }
+        a[0] <<= 1;
+        if (overflow) {
+            for (int i = 0; i < 4; ++i) {
+                a[i] ^= CHARACTERISTIC[i];
+            }
+        }
+    }
+
+    static constexpr Polynomial multiply(Polynomial a, const Polynomial& b) {
+        Polynomial product{};
+        for (std::uint64_t word : b) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (std::uint64_t{1} << bit)) {
+                    for (int i = 0; i < 4; ++i) {
+                        product[i] ^= a[i];
+                    }
+                }
+                timesX(a);
+            }
+        }
+        return product;
+    }
+
+    // x^n mod the characteristic polynomial, by square and multiply
+    static constexpr Polynomial powerOfX(std::uint64_t n) {
+        Polynomial result{1, 0, 0, 0};
+        for (int bit = 63; bit >= 0; --bit) {
+            result = multiply(result, result);
+            if (n & (std::uint64_t{1} << bit)) {
+                timesX(result);
+            }
+        }
+        return result;
+    }
+
+    constexpr void applyJump(const Polynomial& polynomial) {
+        std::array<std::uint64_t, 4> s{};
+        for (std::uint64_t word : polynomial) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (std::uint64_t{1} << bit)) {
+                    for (int i = 0; i < 4; ++i) {
+                        s[i] ^= m_s[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        m_s = s;
+    }
+
+    std::array<std::uint64_t, 4> m_s{};
+};
+
+// Unbiased integer in [0, range) using Lemire's multiply-shift method.
+// The rejection threshold is computed once up front, so the sampling
+// itself never divides; a retry happens with probability below range / 2^32.
+class BoundedSampler {
+public:
+    explicit constexpr BoundedSampler(std::uint32_t range)
+        : m_range(range)
+        , m_threshold(static_cast<std::uint32_t>(-range) % range)
+    {
+    }
+
+    constexpr std::uint32_t range() const { return m_range; }
+
+    template <typename Generator>
+    constexpr std::uint32_t operator()(Generator& gen) const {
+        std::uint64_t m = static_cast<std::uint64_t>(static_cast<std::uint32_t>(gen() >> 32)) * m_range;
+        while (static_cast<std::uint32_t>(m) < m_threshold) {
+            m = static_cast<std::uint64_t>(static_cast<std::uint32_t>(gen() >> 32)) * m_range;
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+private:
+    std::uint32_t m_range;
+    std::uint32_t m_threshold;
+};
+
+#endif // RNG_H
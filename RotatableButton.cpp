@@ -1,4 +1,6 @@
 #include "RotatableButton.h"
+#include "ShadowSprite.h"
+#include "Trace.h"
 #include <QPainter>
 #include <QPaintEvent>
 #include <QStyleOptionButton>
@@ -23,6 +25,20 @@ void RotatableButton::setRotation(qreal rotation)
     update();
 }
 
+void RotatableButton::setScale(qreal scale)
+{
+    m_scale = scale;
+    update();
+}
+
+void RotatableButton::setShadowVisible(bool visible)
+{
+    if (m_shadowVisible != visible) {
+        m_shadowVisible = visible;
+        update();
+    }
+}
+
 void RotatableButton::setButtonSize(const QSize &size)
 {
     m_buttonSize = size;
@@ -44,37 +60,76 @@ void RotatableButton::resizeEvent(QResizeEvent *event)
     QPushButton::resizeEvent(event);
 }
 
+void RotatableButton::changeEvent(QEvent *event)
+{
+    switch (event->type()) {
+        case QEvent::StyleChange: // Also sent by setStyleSheet
+        case QEvent::FontChange:
+        case QEvent::PaletteChange:
+        case QEvent::EnabledChange:
+            invalidateFace();
+            break;
+        default:
+            break;
+    }
+    QPushButton::changeEvent(event);
+}
+
+const QPixmap &RotatableButton::cachedFace(const QStyleOptionButton &option)
+{
+    FaceKey key{option.text, option.state, m_buttonSize, devicePixelRatioF()};
+    if (key == m_faceKey && !m_face.isNull()) {
+        return m_face;
+    }
+
+    // Render the face unrotated at device resolution, so blitting it stays sharp on HiDPI screens
+    m_face = QPixmap(m_buttonSize * key.devicePixelRatio);
+    m_face.setDevicePixelRatio(key.devicePixelRatio);
+    m_face.fill(Qt::transparent);
+
+    QPainter facePainter(&m_face);
+    facePainter.setRenderHint(QPainter::Antialiasing);
+    QStyleOptionButton faceOption = option;
+    faceOption.rect = QRect(QPoint(0, 0), m_buttonSize);
+    style()->drawControl(QStyle::CE_PushButton, &faceOption, &facePainter, this);
+
+    m_faceKey = key;
+    return m_face;
+}
+
 void RotatableButton::paintEvent(QPaintEvent *event)
 {
+    FMCHNE_TRACE_SCOPE("RotatableButton::paintEvent");
     Q_UNUSED(event);
 
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    if (m_buttonSize.isEmpty()) {
+        return;
+    }
 
-    // Save state
-    painter.save();
+    // Create and configure style option
+    QStyleOptionButton option;
+    initStyleOption(&option);
+    const QPixmap &face = cachedFace(option);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_rotation != 0 || m_scale != 1);
 
     // Calculate center point
     QPointF center = rect().center();
 
-    // Setup rotation around center
+    // Setup rotation and scale around center
     painter.translate(center);
     painter.rotate(m_rotation);
+    painter.scale(m_scale, m_scale);
     painter.translate(-center);
 
     // Calculate position to center the button in the container
     int x = (width() - m_buttonSize.width()) / 2;
     int y = (height() - m_buttonSize.height()) / 2;
 
-    // Create and configure style option
-    QStyleOptionButton option;
-    initStyleOption(&option);
-    option.rect = QRect(x, y, m_buttonSize.width(), m_buttonSize.height());
-
-    // Draw the button
-    style()->drawControl(QStyle::CE_PushButton, &option, &painter, this);
-
-    // Restore state
-    painter.restore();
+    if (m_shadowVisible) {
+        ShadowSprite::draw(painter, QRectF(x, y, m_buttonSize.width(), m_buttonSize.height()),
+                           FACE_CORNER_RADIUS, SHADOW_BLUR_RADIUS);
+    }
+    painter.drawPixmap(x, y, face);
 }
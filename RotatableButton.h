@@ -1,27 +1,60 @@
 #ifndef ROTATABLEBUTTON_H
 #define ROTATABLEBUTTON_H
 
+#include <QPixmap>
 #include <QPushButton>
+#include <QStyle>
 
 class RotatableButton : public QPushButton
 {
     Q_OBJECT
     Q_PROPERTY(qreal rotation READ rotation WRITE setRotation)
+    Q_PROPERTY(qreal scale READ scale WRITE setScale)
 
 public:
     explicit RotatableButton(QWidget *parent = nullptr);
     explicit RotatableButton(const QString &text, QWidget *parent = nullptr);
     qreal rotation() const { return m_rotation; }
     void setRotation(qreal rotation);
+    // Painted size relative to the button size, around the center; the widget keeps its geometry
+    qreal scale() const { return m_scale; }
+    void setScale(qreal scale);
     void setButtonSize(const QSize &size);
+    // Soft shadow under the face, drawn from a cached pre-blurred sprite
+    void setShadowVisible(bool visible);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
 private:
+    static constexpr qreal FACE_CORNER_RADIUS = 10; // Matches the theme's button corners
+    static constexpr qreal SHADOW_BLUR_RADIUS = 10;
+
+    // What the cached face was rendered for; any difference means re-render
+    struct FaceKey {
+        QString text;
+        QStyle::State state;
+        QSize size;
+        qreal devicePixelRatio = 0;
+
+        bool operator==(const FaceKey &other) const {
+            return text == other.text && state == other.state && size == other.size
+                && devicePixelRatio == other.devicePixelRatio;
+        }
+    };
+
     void updateContainerSize();
+    const QPixmap &cachedFace(const QStyleOptionButton &option);
+    void invalidateFace() { m_faceKey = FaceKey(); }
+
+    // Rendered once per key at device resolution, then only blitted rotated
+    QPixmap m_face;
+    FaceKey m_faceKey;
     qreal m_rotation = 0;
+    qreal m_scale = 1;
+    bool m_shadowVisible = false;
     QSize m_buttonSize;  // Actual visual button size
 };
 
@@ -0,0 +1,139 @@
+#include "SaveData.h"
+
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QString>
+
+bool operator==(const SaveData& a, const SaveData& b) {
+    return a.hasCurrent == b.hasCurrent && a.seed == b.seed && a.draws == b.draws && a.state == b.state;
+}
+
+QJsonObject saveDataToJson(const SaveData& data) {
+    QJsonObject saveData;
+
+    // Current game state
+    if (data.hasCurrent) {
+        QJsonObject current;
+        current["Money"] = data.state.money;
+        current["Spins"] = data.state.spinCount;
+        current["MaxMoney"] = data.state.maxMoney;
+        // RNG position, stored as strings since JSON numbers cannot hold 64 bits
+        current["Seed"] = QString::number(data.seed, 16);
+        current["Draws"] = QString::number(data.draws);
+        saveData["Current"] = current;
+    }
+
+    // Overall statistics
+    QJsonObject overall;
+    overall["TotalSpins"] = data.state.totalSpins;
+    overall["TotalMoneyEarnt"] = data.state.totalMoneyEarnt;
+    overall["HighestSpin"] = data.state.highestSpin;
+    overall["AllTimeHighestMoney"] = data.state.allTimeHighestMoney;
+    overall["Runs"] = data.state.runsPlayed;
+    saveData["Overall"] = overall;
+
+    return saveData;
+}
+
+SaveData saveDataFromJson(const QJsonObject& object) {
+    SaveData data;
+
+    // Load current game state
+    data.hasCurrent = object.contains("Current");
+    QJsonObject current = object["Current"].toObject();
+    data.state.money = current["Money"].toInt();
+    data.state.spinCount = current["Spins"].toInt();
+    data.state.maxMoney = current["MaxMoney"].toInt();
+    data.seed = current["Seed"].toString().toULongLong(nullptr, 16);
+    data.draws = current["Draws"].toString().toULongLong();
+
+    // Load overall statistics
+    QJsonObject overall = object["Overall"].toObject();
+    data.state.totalSpins = overall["TotalSpins"].toInt();
+    data.state.totalMoneyEarnt = overall["TotalMoneyEarnt"].toInt();
+    data.state.highestSpin = overall["HighestSpin"].toInt();
+    data.state.allTimeHighestMoney = overall["AllTimeHighestMoney"].toInt();
+    data.state.runsPlayed = overall["Runs"].toInt();
+
+    return data;
+}
+
+QCborMap saveDataToCbor(const SaveData& data) {
+    QCborMap saveData;
+
+    if (data.hasCurrent) {
+        QCborMap current;
+        current[QLatin1String("Money")] = data.state.money;
+        current[QLatin1String("Spins")] = data.state.spinCount;
+        current[QLatin1String("MaxMoney")] = data.state.maxMoney;
+        // CBOR integers are signed 64-bit, so the RNG words are stored bit for bit
+        current[QLatin1String("Seed")] = static_cast<qint64>(data.seed);
+        current[QLatin1String("Draws")] = static_cast<qint64>(data.draws);
+        saveData[QLatin1String("Current")] = current;
+    }
+
+    QCborMap overall;
+    overall[QLatin1String("TotalSpins")] = data.state.totalSpins;
+    overall[QLatin1String("TotalMoneyEarnt")] = data.state.totalMoneyEarnt;
+    overall[QLatin1String("HighestSpin")] = data.state.highestSpin;
+    overall[QLatin1String("AllTimeHighestMoney")] = data.state.allTimeHighestMoney;
+    overall[QLatin1String("Runs")] = data.state.runsPlayed;
+    saveData[QLatin1String("Overall")] = overall;
+
+    return saveData;
+}
+
+SaveData saveDataFromCbor(const QCborMap& map) {
+    SaveData data;
+
+    data.hasCurrent = map.contains(QLatin1String("Current"));
+    const QCborMap current = map.value(QLatin1String("Current")).toMap();
+    data.state.money = static_cast<int>(current.value(QLatin1String("Money")).toInteger());
+    data.state.spinCount = static_cast<int>(current.value(QLatin1String("Spins")).toInteger());
+    data.state.maxMoney = static_cast<int>(current.value(QLatin1String("MaxMoney")).toInteger());
+    data.seed = static_cast<std::uint64_t>(current.value(QLatin1String("Seed")).toInteger());
+    data.draws = static_cast<std::uint64_t>(current.value(QLatin1String("Draws")).toInteger());
+
+    const QCborMap overall = map.value(QLatin1String("Overall")).toMap();
+    data.state.totalSpins = static_cast<int>(overall.value(QLatin1String("TotalSpins")).toInteger());
+    data.state.totalMoneyEarnt = static_cast<int>(overall.value(QLatin1String("TotalMoneyEarnt")).toInteger());
+    data.state.highestSpin = static_cast<int>(overall.value(QLatin1String("HighestSpin")).toInteger());
+    data.state.allTimeHighestMoney = static_cast<int>(overall.value(QLatin1String("AllTimeHighestMoney")).toInteger());
+    data.state.runsPlayed = static_cast<int>(overall.value(QLatin1String("Runs")).toInteger());
+
+    return data;
+}
+
+QByteArray encodeSnapshot(const SaveData& data, SaveFormat format) {
+    if (format == SaveFormat::Cbor) {
+        return QCborValue(saveDataToCbor(data)).toCbor();
+    }
+    return QJsonDocument(saveDataToJson(data)).toJson();
+}
+
+bool decodeSnapshot(const QByteArray& bytes, SaveData& data) {
+    if (bytes.isEmpty()) {
+        return false;
+    }
+
+    // A CBOR map starts with major type 5 (0xA0-0xBF); JSON text never does
+    const auto first = static_cast<unsigned char>(bytes.front());
+    if (first >= 0xA0 && first <= 0xBF) {
+        QCborParserError error;
+        const QCborValue value = QCborValue::fromCbor(bytes, &error);
+        if (error.error != QCborError::NoError || !value.isMap()) {
+            return false;
+        }
+        data = saveDataFromCbor(value.toMap());
+        return true;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(bytes, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        return false;
+    }
+    data = saveDataFromJson(doc.object());
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef SAVEDATA_H
+#define SAVEDATA_H
+
+#include "SpinEngine.h"
+
+#include <QByteArray>
+#include <QCborMap>
+#include <QJsonObject>
+#include <cstdint>
+
+// Everything written to game_save.json. The current run (money, spins,
+// max money and RNG position) is only meaningful while hasCurrent is set;
+// the overall statistics always are.
+struct SaveData {
+    bool hasCurrent{false};
+    GameState state;
+    std::uint64_t seed{0};
+    std::uint64_t draws{0};
+};
+
+bool operator==(const SaveData& a, const SaveData& b);
+inline bool operator!=(const SaveData& a, const SaveData& b) { return !(a == b); }
+
+// Snapshot encodings. JSON is the readable default; CBOR uses the same keys
+// with native integers, so it is smaller and cheaper to parse.
+enum class SaveFormat {
+    Json,
+    Cbor
+};
+
+QJsonObject saveDataToJson(const SaveData& data);
+SaveData saveDataFromJson(const QJsonObject& object);
+QCborMap saveDataToCbor(const SaveData& data);
+SaveData saveDataFromCbor(const QCborMap& map);
+
+QByteArray encodeSnapshot(const SaveData& data, SaveFormat format);
+// Detects the encoding from the first byte; false if neither parses
+bool decodeSnapshot(const QByteArray& bytes, SaveData& data);
+
+#endif // SAVEDATA_H
@@ -0,0 +1,252 @@
+#include "SaveJournal.h"
+#include "Trace.h"
+
+#include <QSaveFile>
+#include <QtEndian>
+#include <array>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr quint32 RECORD_VERSION = 1;
+constexpr int HEADER_SIZE = 8;
+constexpr int PAYLOAD_SIZE = 52;
+constexpr int RECORD_SIZE = HEADER_SIZE + PAYLOAD_SIZE;
+
+constexpr std::array<quint32, 256> makeCrcTable() {
+    std::array<quint32, 256> table{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<quint32, 256> CRC_TABLE = makeCrcTable();
+
+// CRC-32 (IEEE 802.3), the same polynomial zlib uses
+quint32 crc32(const uchar* data, int length) {
+    quint32 crc = 0xFFFFFFFFu;
+    for (int i = 0; i < length; ++i) {
+        crc = CRC_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void encodeRecord(const SaveData& data, uchar* record) {
+    uchar* payload = record + HEADER_SIZE;
+    const GameState& s = data.state;
+    const qint32 fields[] = {
+        s.money, s.spinCount, s.maxMoney, s.highestSpin,
+        s.totalSpins, s.totalMoneyEarnt, s.allTimeHighestMoney, s.runsPlayed
+    };
+
+    payload[0] = static_cast<uchar>(RECORD_VERSION);
+    payload[1] = data.hasCurrent ? 1 : 0;
+    payload[2] = 0;
+    payload[3] = 0;
+    for (int i = 0; i < 8; ++i) {
+        qToLittleEndian<qint32>(fields[i], payload + 4 + i * 4);
+    }
+    qToLittleEndian<quint64>(data.seed, payload + 36);
+    qToLittleEndian<quint64>(data.draws, payload + 44);
+
+    qToLittleEndian<quint32>(PAYLOAD_SIZE, record);
+    qToLittleEndian<quint32>(crc32(payload, PAYLOAD_SIZE), record + 4);
+}
+
+bool decodeRecord(const uchar* record, qint64 available, SaveData& data) {
+    if (available < RECORD_SIZE) {
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(record) != PAYLOAD_SIZE) {
+        return false;
+    }
+    const uchar* payload = record + HEADER_SIZE;
+    if (qFromLittleEndian<quint32>(record + 4) != crc32(payload, PAYLOAD_SIZE)) {
+        return false;
+    }
+    if (payload[0] != RECORD_VERSION) {
+        return false;
+    }
+
+    GameState& s = data.state;
+    int* fields[] = {
+        &s.money, &s.spinCount, &s.maxMoney, &s.highestSpin,
+        &s.totalSpins, &s.totalMoneyEarnt, &s.allTimeHighestMoney, &s.runsPlayed
+    };
+    data.hasCurrent = payload[1] != 0;
+    for (int i = 0; i < 8; ++i) {
+        *fields[i] = qFromLittleEndian<qint32>(payload + 4 + i * 4);
+    }
+    data.seed = qFromLittleEndian<quint64>(payload + 36);
+    data.draws = qFromLittleEndian<quint64>(payload + 44);
+    return true;
+}
+
+// Maps the whole file when possible, falling back to reading it
+QByteArray mapFile(QFile& file) {
+    const qint64 size = file.size();
+    if (size <= 0) {
+        return {};
+    }
+    if (uchar* mapped = file.map(0, size)) {
+        // Valid until the file is closed, callers parse before that
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<qsizetype>(size));
+    }
+    return file.readAll();
+}
+
+// Replays intact records over data and returns the offset just past the last one
+qint64 replay(const QByteArray& journal, SaveData& data, int& records) {
+    const auto* bytes = reinterpret_cast<const uchar*>(journal.constData());
+    qint64 offset = 0;
+    records = 0;
+    while (decodeRecord(bytes + offset, journal.size() - offset, data)) {
+        offset += RECORD_SIZE;
+        records++;
+    }
+    return offset;
+}
+
+} // namespace
+
+SaveJournal::SaveJournal(const QString& snapshotPath)
+    : m_snapshotPath(snapshotPath)
+{
+    m_sinceSync.start();
+}
+
+SaveJournal::~SaveJournal() {
+    close();
+}
+
+QString SaveJournal::journalPath(const QString& snapshotPath) {
+    return snapshotPath + ".journal";
+}
+
+bool SaveJournal::load(const QString& snapshotPath, SaveData& data) {
+    FMCHNE_TRACE_SCOPE("SaveJournal::load");
+    bool found = false;
+    data = SaveData{};
+
+    QFile snapshot(snapshotPath);
+    if (snapshot.open(QIODevice::ReadOnly)) {
+        found = decodeSnapshot(mapFile(snapshot), data);
+    }
+
+    QFile journal(journalPath(snapshotPath));
+    if (journal.open(QIODevice::ReadOnly)) {
+        int records = 0;
+        replay(mapFile(journal), data, records);
+        found = found || records > 0;
+    }
+    return found;
+}
+
+void SaveJournal::setSyncPolicy(SyncPolicy policy, int intervalMs) {
+    m_syncPolicy = policy;
+    m_syncIntervalMs = intervalMs;
+}
+
+bool SaveJournal::openJournal() {
+    m_journal.setFileName(journalPath(m_snapshotPath));
+    if (!m_journal.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    // Drop a torn tail left by a crash so new records follow the last good one
+    SaveData scratch;
+    const qint64 validEnd = replay(m_journal.readAll(), scratch, m_recordsSinceCompaction);
+    if (validEnd != m_journal.size()) {
+        m_journal.resize(validEnd);
+    }
+    return m_journal.seek(validEnd);
+}
+
+bool SaveJournal::sync() {
+    if (!m_journal.isOpen() || !m_journal.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    const bool synced = _commit(m_journal.handle()) == 0;
+#else
+    const bool synced = ::fsync(m_journal.handle()) == 0;
+#endif
+    m_sinceSync.restart();
+    m_dirty = !synced;
+    return synced;
+}
+
+bool SaveJournal::append(const SaveData& data) {
+    FMCHNE_TRACE_SCOPE("SaveJournal::append");
+    if (!m_journal.isOpen() && !openJournal()) {
+        return false;
+    }
+
+    uchar record[RECORD_SIZE];
+    encodeRecord(data, record);
+    if (m_journal.write(reinterpret_cast<const char*>(record), RECORD_SIZE) != RECORD_SIZE) {
+        return false;
+    }
+    m_last = data;
+    m_hasLast = true;
+    m_dirty = true;
+    m_recordsSinceCompaction++;
+
+    if (m_recordsSinceCompaction >= m_compactionThreshold) {
+        return compact(data);
+    }
+    switch (m_syncPolicy) {
+        case SyncPolicy::EveryRecord:
+            return sync();
+        case SyncPolicy::Interval:
+            if (m_sinceSync.hasExpired(m_syncIntervalMs)) {
+                return sync();
+            }
+            break;
+        case SyncPolicy::OnClose:
+            break;
+    }
+    return true;
+}
+
+bool SaveJournal::compact(const SaveData& data) {
+    FMCHNE_TRACE_SCOPE("SaveJournal::compact");
+    // QSaveFile writes to a temporary and renames it over the snapshot on commit
+    QSaveFile snapshot(m_snapshotPath);
+    if (!snapshot.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    snapshot.write(encodeSnapshot(data, m_snapshotFormat));
+    if (!snapshot.commit()) {
+        return false;
+    }
+
+    if (!m_journal.isOpen() && !openJournal()) {
+        return false;
+    }
+    m_journal.resize(0);
+    m_journal.seek(0);
+    m_recordsSinceCompaction = 0;
+    m_last = data;
+    m_hasLast = true;
+    return sync();
+}
+
+void SaveJournal::close() {
+    if (m_hasLast && m_recordsSinceCompaction > 0) {
+        compact(m_last);
+    } else if (m_dirty) {
+        sync();
+    }
+    m_journal.close();
+}
@@ -0,0 +1,70 @@
+#ifndef SAVEJOURNAL_H
+#define SAVEJOURNAL_H
+
+#include "SaveData.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+/*
+ Append-only persistence for SaveData.
+
+ game_save.json stays the snapshot. Every save appends one fixed-size
+ record to game_save.json.journal:
+
+   u32 payload length | u32 CRC-32 of payload | payload
+
+ The payload is the complete post-spin SaveData (52 bytes), not a diff, so
+ loading is "snapshot, then the last intact record wins". A torn or
+ corrupt tail simply ends the replay and is truncated on the next write.
+ Every compactionThreshold records the journal is folded into a fresh
+ snapshot (written atomically) and emptied. A crash between those two
+ steps is harmless because the journal's last record equals the snapshot.
+*/
+class SaveJournal {
+public:
+    enum class SyncPolicy {
+        EveryRecord, // fsync after each append
+        Interval,    // fsync at most once per syncInterval
+        OnClose      // only when the journal is compacted or closed
+    };
+
+    explicit SaveJournal(const QString& snapshotPath);
+    ~SaveJournal();
+
+    SaveJournal(const SaveJournal&) = delete;
+    SaveJournal& operator=(const SaveJournal&) = delete;
+
+    // Snapshot plus every intact journal record; false if neither exists.
+    // Both files are memory-mapped rather than read into a buffer.
+    static bool load(const QString& snapshotPath, SaveData& data);
+    static QString journalPath(const QString& snapshotPath);
+
+    void setSyncPolicy(SyncPolicy policy, int intervalMs = 1000);
+    void setCompactionThreshold(int records) { m_compactionThreshold = records; }
+    void setSnapshotFormat(SaveFormat format) { m_snapshotFormat = format; }
+
+    bool append(const SaveData& data);
+    bool compact(const SaveData& data);
+    // Compacts the last appended state and releases the file
+    void close();
+
+private:
+    bool openJournal();
+    bool sync();
+
+    QString m_snapshotPath;
+    QFile m_journal;
+    SyncPolicy m_syncPolicy{SyncPolicy::Interval};
+    int m_syncIntervalMs{1000};
+    int m_compactionThreshold{1024};
+    SaveFormat m_snapshotFormat{SaveFormat::Json};
+    int m_recordsSinceCompaction{0};
+    bool m_dirty{false};
+    bool m_hasLast{false};
+    SaveData m_last;
+    QElapsedTimer m_sinceSync;
+};
+
+#endif // SAVEJOURNAL_H
@@ -0,0 +1,48 @@
+#include "SaveModel.h"
+
+#include "SaveJournal.h"
+
+SaveModel::SaveModel(const QString& snapshotPath, SaveFormat format)
+    : m_snapshotPath(snapshotPath)
+    , m_writer(snapshotPath, format)
+{
+}
+
+void SaveModel::ensureLoaded() const {
+    if (m_loaded) {
+        return;
+    }
+    m_exists = SaveJournal::load(m_snapshotPath, m_data);
+    m_loaded = true;
+}
+
+bool SaveModel::hasCurrentRun() const {
+    ensureLoaded();
+    return m_data.hasCurrent;
+}
+
+bool SaveModel::loadCurrent(SaveData& data) const {
+    ensureLoaded();
+    data = m_data;
+    return m_exists;
+}
+
+void SaveModel::save(const SaveData& data) {
+    ensureLoaded();
+    if (m_exists && data == m_data) {
+        return;
+    }
+    m_data = data;
+    m_exists = true;
+    m_writer.submit(m_data);
+}
+
+void SaveModel::dropCurrent() {
+    ensureLoaded();
+    if (!m_exists || !m_data.hasCurrent) {
+        return;
+    }
+    SaveData dropped = m_data;
+    dropped.hasCurrent = false;
+    save(dropped);
+}
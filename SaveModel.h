@@ -0,0 +1,40 @@
+#ifndef SAVEMODEL_H
+#define SAVEMODEL_H
+
+#include "SaveData.h"
+#include "SaveWriter.h"
+
+#include <QString>
+
+// In-memory view of the save file. The snapshot and journal are parsed once,
+// on first use, and every question after that ("is there a run to continue",
+// "load it", "drop it") is answered from memory. Changes go to the background
+// writer only when they actually differ from what is already saved.
+class SaveModel {
+public:
+    explicit SaveModel(const QString& snapshotPath, SaveFormat format = SaveFormat::Json);
+
+    bool hasCurrentRun() const;
+    // Current run plus overall stats; false if there was nothing saved
+    bool loadCurrent(SaveData& data) const;
+    void save(const SaveData& data);
+    // Forgets the current run but keeps the overall statistics
+    void dropCurrent();
+
+    // Durably writes anything pending and stops the writer thread
+    void close() { m_writer.stop(); }
+    const SaveWriter& writer() const { return m_writer; }
+
+private:
+    void ensureLoaded() const;
+
+    QString m_snapshotPath;
+    SaveWriter m_writer;
+
+    // Lazily filled by the first query, hence mutable
+    mutable bool m_loaded{false};
+    mutable bool m_exists{false};
+    mutable SaveData m_data;
+};
+
+#endif // SAVEMODEL_H
@@ -0,0 +1,86 @@
+#include "SaveWriter.h"
+#include "Trace.h"
+
+#include <chrono>
+
+namespace {
+
+std::uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+SaveWriter::SaveWriter(const QString& snapshotPath, SaveFormat snapshotFormat,
+                       SaveJournal::SyncPolicy syncPolicy, int coalesceMs)
+    : m_snapshotPath(snapshotPath)
+    , m_snapshotFormat(snapshotFormat)
+    , m_syncPolicy(syncPolicy)
+    , m_coalesceMs(coalesceMs)
+{
+    m_thread = std::thread(&SaveWriter::run, this);
+}
+
+SaveWriter::~SaveWriter() {
+    stop();
+}
+
+void SaveWriter::submit(const SaveData& data) {
+    const auto start = std::chrono::steady_clock::now();
+
+    m_mailbox.publish(data);
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+    m_pending.store(true, std::memory_order_release);
+    m_wake.notify_one();
+
+    m_submitLatency.record(nanosecondsSince(start));
+}
+
+void SaveWriter::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    m_stop.store(true, std::memory_order_release);
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void SaveWriter::run() {
+    Trace::setThreadName("SaveWriter");
+    SaveJournal journal(m_snapshotPath);
+    journal.setSyncPolicy(m_syncPolicy);
+    journal.setSnapshotFormat(m_snapshotFormat);
+
+    SaveData data;
+    std::uint64_t written = 0;
+    for (;;) {
+        {
+            // The timeout covers a notify that lands between the check and the wait
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                return m_stop.load(std::memory_order_acquire) || m_pending.load(std::memory_order_acquire);
+            });
+        }
+        const bool stopping = m_stop.load(std::memory_order_acquire);
+        if (!stopping && m_pending.load(std::memory_order_acquire) && m_coalesceMs > 0) {
+            // Let the rest of a burst land so only its last snapshot is written
+            std::this_thread::sleep_for(std::chrono::milliseconds(m_coalesceMs));
+        }
+
+        m_pending.store(false, std::memory_order_release);
+        if (m_mailbox.consume(data)) {
+            const auto start = std::chrono::steady_clock::now();
+            journal.append(data);
+            m_writeLatency.record(nanosecondsSince(start));
+            written++;
+            m_coalesced.store(m_submitted.load(std::memory_order_relaxed) - written, std::memory_order_relaxed);
+        }
+        if (stopping) {
+            break;
+        }
+    }
+
+    // Compacts into the snapshot and syncs whatever the sync policy left pending
+    journal.close();
+}
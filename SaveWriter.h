@@ -0,0 +1,62 @@
+#ifndef SAVEWRITER_H
+#define SAVEWRITER_H
+
+#include "LatencyHistogram.h"
+#include "SaveData.h"
+#include "SaveJournal.h"
+#include "TripleBuffer.h"
+
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Persistence worker. The UI thread hands over immutable SaveData snapshots
+// through a lock-free latest-value mailbox and never touches the disk; the
+// worker waits out a short coalescing window so a burst of spins becomes a
+// single journal append, and stop() drains the final snapshot and compacts
+// the journal before returning.
+class SaveWriter {
+public:
+    explicit SaveWriter(const QString& snapshotPath,
+                        SaveFormat snapshotFormat = SaveFormat::Json,
+                        SaveJournal::SyncPolicy syncPolicy = SaveJournal::SyncPolicy::Interval,
+                        int coalesceMs = 20);
+    ~SaveWriter();
+
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+
+    // Producer side, UI thread only
+    void submit(const SaveData& data);
+
+    // Flushes the pending snapshot durably and joins the worker; idempotent
+    void stop();
+
+    const LatencyHistogram& submitLatency() const { return m_submitLatency; }
+    const LatencyHistogram& writeLatency() const { return m_writeLatency; }
+    std::uint64_t coalescedCount() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    QString m_snapshotPath;
+    SaveFormat m_snapshotFormat;
+    SaveJournal::SyncPolicy m_syncPolicy;
+    int m_coalesceMs;
+
+    TripleBuffer<SaveData> m_mailbox;
+    std::atomic<bool> m_pending{false};
+    std::atomic<bool> m_stop{false};
+    std::atomic<std::uint64_t> m_submitted{0};
+    std::atomic<std::uint64_t> m_coalesced{0};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    LatencyHistogram m_submitLatency;
+    LatencyHistogram m_writeLatency;
+    std::thread m_thread;
+};
+
+#endif // SAVEWRITER_H
@@ -0,0 +1,243 @@
+#include "SessionLog.h"
+#include "PaytableFile.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace {
+
+// Version 1 logs have no paytable and were all played on the default one
+constexpr int SESSION_VERSION = 2;
+
+const char* actionName(SessionAction action) {
+    switch (action) {
+        case SessionAction::Spin: return "spin";
+        case SessionAction::Claim: return "claim";
+        case SessionAction::BeginRun: return "beginRun";
+        case SessionAction::ResetRun: return "resetRun";
+        case SessionAction::Restore: return "restore";
+        case SessionAction::SetPaytable: return "setPaytable";
+    }
+    return "";
+}
+
+bool actionFromName(const QString& name, SessionAction& action) {
+    for (SessionAction candidate : {SessionAction::Spin, SessionAction::Claim, SessionAction::BeginRun,
+                                    SessionAction::ResetRun, SessionAction::Restore, SessionAction::SetPaytable}) {
+        if (name == QLatin1String(actionName(candidate))) {
+            action = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Same key names as the save file
+QJsonObject stateToJson(const GameState& state) {
+    QJsonObject object;
+    object["Money"] = state.money;
+    object["Spins"] = state.spinCount;
+    object["MaxMoney"] = state.maxMoney;
+    object["TotalSpins"] = state.totalSpins;
+    object["TotalMoneyEarnt"] = state.totalMoneyEarnt;
+    object["HighestSpin"] = state.highestSpin;
+    object["AllTimeHighestMoney"] = state.allTimeHighestMoney;
+    object["Runs"] = state.runsPlayed;
+    return object;
+}
+
+GameState stateFromJson(const QJsonObject& object) {
+    GameState state;
+    state.money = object["Money"].toInt();
+    state.spinCount = object["Spins"].toInt();
+    state.maxMoney = object["MaxMoney"].toInt();
+    state.totalSpins = object["TotalSpins"].toInt();
+    state.totalMoneyEarnt = object["TotalMoneyEarnt"].toInt();
+    state.highestSpin = object["HighestSpin"].toInt();
+    state.allTimeHighestMoney = object["AllTimeHighestMoney"].toInt();
+    state.runsPlayed = object["Runs"].toInt();
+    return state;
+}
+
+// 64-bit values as strings, JSON numbers cannot hold them exactly
+QString hex64(std::uint64_t value) { return QString::number(value, 16); }
+QString decimal64(std::uint64_t value) { return QString::number(value); }
+
+} // namespace
+
+void SessionRecorder::start(const SpinEngine& engine) {
+    m_log = SessionLog();
+    m_log.seed = engine.seed();
+    m_log.draws = engine.draws();
+    m_log.start = engine.state();
+    m_log.paytable = engine.paytable();
+}
+
+void SessionRecorder::spins(const SpinEngine& engine, std::uint64_t count) {
+    if (count == 0 || m_paused) {
+        return;
+    }
+    if (!m_log.events.empty() && m_log.events.back().action == SessionAction::Spin) {
+        SessionEvent& last = m_log.events.back();
+        last.count += count;
+        last.state = engine.state();
+        last.draws = engine.draws();
+        return;
+    }
+    push(SessionAction::Spin, engine, count);
+}
+
+void SessionRecorder::push(SessionAction action, const SpinEngine& engine, std::uint64_t count) {
+    if (m_paused) {
+        return;
+    }
+    SessionEvent event;
+    event.action = action;
+    event.count = count;
+    event.state = engine.state();
+    event.seed = engine.seed();
+    event.draws = engine.draws();
+    event.paytable = engine.paytable();
+    m_log.events.push_back(event);
+}
+
+ReplayResult replaySession(const SessionLog& log) {
+    ReplayResult result;
+    SpinEngine engine(log.seed);
+    engine.reseed(log.seed, log.draws);
+    engine.setState(log.start);
+    engine.setPaytable(log.paytable);
+
+    for (std::size_t i = 0; i < log.events.size(); ++i) {
+        const SessionEvent& event = log.events[i];
+        switch (event.action) {
+            case SessionAction::Spin:
+                for (std::uint64_t spin = 0; spin < event.count; ++spin) {
+                    engine.spin();
+                }
+                result.spins += event.count;
+                break;
+            case SessionAction::Claim:
+                engine.claim();
+                break;
+            case SessionAction::BeginRun:
+                engine.beginRun();
+                break;
+            case SessionAction::ResetRun:
+                engine.resetRun();
+                break;
+            case SessionAction::Restore:
+                engine.setState(event.state);
+                engine.reseed(event.seed, event.draws);
+                break;
+            case SessionAction::SetPaytable:
+                engine.setPaytable(event.paytable);
+                break;
+        }
+
+        result.expected = event.state;
+        result.actual = engine.state();
+        result.expectedDraws = event.draws;
+        result.actualDraws = engine.draws();
+        if (result.actual != result.expected || result.actualDraws != result.expectedDraws) {
+            result.matched = false;
+            result.eventIndex = i;
+            return result;
+        }
+    }
+    return result;
+}
+
+QJsonObject sessionToJson(const SessionLog& log) {
+    QJsonArray events;
+    for (const SessionEvent& event : log.events) {
+        QJsonObject object;
+        object["Action"] = actionName(event.action);
+        if (event.action == SessionAction::Spin) {
+            object["Count"] = decimal64(event.count);
+        }
+        if (event.action == SessionAction::Restore) {
+            object["Seed"] = hex64(event.seed);
+        }
+        if (event.action == SessionAction::SetPaytable) {
+            object["Paytable"] = paytableToJson(event.paytable);
+        }
+        object["Draws"] = decimal64(event.draws);
+        object["State"] = stateToJson(event.state);
+        events.append(object);
+    }
+
+    QJsonObject session;
+    session["Version"] = SESSION_VERSION;
+    session["Seed"] = hex64(log.seed);
+    session["Draws"] = decimal64(log.draws);
+    session["Start"] = stateToJson(log.start);
+    session["Paytable"] = paytableToJson(log.paytable);
+    session["Events"] = events;
+    return session;
+}
+
+bool sessionFromJson(const QJsonObject& object, SessionLog& log) {
+    const int version = object["Version"].toInt();
+    if (version < 1 || version > SESSION_VERSION) {
+        return false;
+    }
+
+    SessionLog parsed;
+    parsed.seed = object["Seed"].toString().toULongLong(nullptr, 16);
+    parsed.draws = object["Draws"].toString().toULongLong();
+    parsed.start = stateFromJson(object["Start"].toObject());
+    if (version >= 2 && !paytableFromJson(object["Paytable"].toObject(), parsed.paytable)) {
+        return false;
+    }
+
+    std::uint64_t seed = parsed.seed;
+    Paytable paytable = parsed.paytable;
+    const QJsonArray events = object["Events"].toArray();
+    parsed.events.reserve(static_cast<std::size_t>(events.size()));
+    for (const QJsonValue& value : events) {
+        const QJsonObject entry = value.toObject();
+        SessionEvent event;
+        if (!actionFromName(entry["Action"].toString(), event.action)) {
+            return false;
+        }
+        if (event.action == SessionAction::Spin) {
+            event.count = entry["Count"].toString().toULongLong();
+        }
+        if (event.action == SessionAction::Restore) {
+            seed = entry["Seed"].toString().toULongLong(nullptr, 16);
+        }
+        if (event.action == SessionAction::SetPaytable
+            && !paytableFromJson(entry["Paytable"].toObject(), paytable)) {
+            return false;
+        }
+        event.seed = seed;
+        event.paytable = paytable;
+        event.draws = entry["Draws"].toString().toULongLong();
+        event.state = stateFromJson(entry["State"].toObject());
+        parsed.events.push_back(event);
+    }
+
+    log = std::move(parsed);
+    return true;
+}
+
+bool writeSession(const QString& path, const SessionLog& log) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(sessionToJson(log)).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+bool readSession(const QString& path, SessionLog& log) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    return document.isObject() && sessionFromJson(document.object(), log);
+}
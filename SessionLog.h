@@ -0,0 +1,92 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include "SpinEngine.h"
+
+#include <QJsonObject>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ Deterministic session recording.
+
+ The engine is fully determined by its seed, RNG position, starting state,
+ paytable and the actions applied to it, so that is all a session stores. Runs of
+ consecutive spins collapse into one event, which keeps auto spin batches
+ small. Every event also carries the state and RNG position the engine had
+ right after it, so a replay can say exactly where it diverged.
+*/
+enum class SessionAction {
+    Spin,
+    Claim,
+    BeginRun,
+    ResetRun,
+    Restore,    // State and RNG position replaced wholesale, e.g. continuing a save
+    SetPaytable // A different paytable swapped in, e.g. its file was edited
+};
+
+struct SessionEvent {
+    SessionAction action{SessionAction::Spin};
+    std::uint64_t count{1}; // Spins in a row; 1 for everything else
+    GameState state;        // After the action
+    std::uint64_t seed{0};  // After the action; only changes on Restore
+    std::uint64_t draws{0};
+    Paytable paytable;      // After the action; only changes on SetPaytable
+};
+
+struct SessionLog {
+    std::uint64_t seed{0};
+    std::uint64_t draws{0};
+    GameState start;
+    Paytable paytable; // In play when the session started
+    std::vector<SessionEvent> events;
+};
+
+// Mirrors engine mutations into a SessionLog; call each hook right after
+// the matching SpinEngine call.
+class SessionRecorder {
+public:
+    void start(const SpinEngine& engine);
+
+    void spins(const SpinEngine& engine, std::uint64_t count = 1);
+    void claim(const SpinEngine& engine) { push(SessionAction::Claim, engine); }
+    void beginRun(const SpinEngine& engine) { push(SessionAction::BeginRun, engine); }
+    void resetRun(const SpinEngine& engine) { push(SessionAction::ResetRun, engine); }
+    void restore(const SpinEngine& engine) { push(SessionAction::Restore, engine); }
+    void setPaytable(const SpinEngine& engine) { push(SessionAction::SetPaytable, engine); }
+
+    const SessionLog& log() const { return m_log; }
+
+    // While paused nothing is recorded, e.g. while the UI is driven only to
+    // measure it; the engine must be back where it was by the time recording resumes
+    void setPaused(bool paused) { m_paused = paused; }
+    bool isPaused() const { return m_paused; }
+
+private:
+    void push(SessionAction action, const SpinEngine& engine, std::uint64_t count = 1);
+
+    SessionLog m_log;
+    bool m_paused{false};
+};
+
+struct ReplayResult {
+    bool matched{true};
+    std::size_t eventIndex{0}; // First event whose outcome differed, when not matched
+    std::uint64_t spins{0};
+    GameState expected;
+    GameState actual;
+    std::uint64_t expectedDraws{0};
+    std::uint64_t actualDraws{0};
+};
+
+// Plays the log on a fresh engine, with the paytables it records, and checks the state and RNG position after every event
+ReplayResult replaySession(const SessionLog& log);
+
+QJsonObject sessionToJson(const SessionLog& log);
+bool sessionFromJson(const QJsonObject& object, SessionLog& log);
+bool writeSession(const QString& path, const SessionLog& log);
+bool readSession(const QString& path, SessionLog& log);
+
+#endif // SESSIONLOG_H
@@ -0,0 +1,140 @@
+#include "ShadowSprite.h"
+
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QtMath>
+#include <qdrawutil.h>
+#include <vector>
+
+namespace {
+
+struct SpriteKey {
+    int cornerRadius;
+    int blurRadius;
+    QRgb color;
+    int dprPercent;
+
+    bool operator==(const SpriteKey& other) const {
+        return cornerRadius == other.cornerRadius && blurRadius == other.blurRadius
+            && color == other.color && dprPercent == other.dprPercent;
+    }
+};
+
+size_t qHash(const SpriteKey& key, size_t seed = 0) {
+    return qHashMulti(seed, key.cornerRadius, key.blurRadius, key.color, key.dprPercent);
+}
+
+// One horizontal then one vertical running-sum box blur of the alpha channel
+void boxBlurAlpha(QImage& image, int radius) {
+    if (radius <= 0) {
+        return;
+    }
+    const int width = image.width();
+    const int height = image.height();
+    const int window = 2 * radius + 1;
+    std::vector<int> line(static_cast<size_t>(qMax(width, height)));
+
+    for (int y = 0; y < height; ++y) {
+        auto* row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = qAlpha(row[x]);
+        }
+        int sum = 0;
+        for (int x = -radius; x <= radius; ++x) {
+            sum += (x >= 0 && x < width) ? line[x] : 0;
+        }
+        for (int x = 0; x < width; ++x) {
+            row[x] = qRgba(0, 0, 0, sum / window);
+            const int out = x - radius;
+            const int in = x + radius + 1;
+            sum += (in < width ? line[in] : 0) - (out >= 0 ? line[out] : 0);
+        }
+    }
+
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            line[y] = qAlpha(reinterpret_cast<const QRgb*>(image.constScanLine(y))[x]);
+        }
+        int sum = 0;
+        for (int y = -radius; y <= radius; ++y) {
+            sum += (y >= 0 && y < height) ? line[y] : 0;
+        }
+        for (int y = 0; y < height; ++y) {
+            reinterpret_cast<QRgb*>(image.scanLine(y))[x] = qRgba(0, 0, 0, sum / window);
+            const int out = y - radius;
+            const int in = y + radius + 1;
+            sum += (in < height ? line[in] : 0) - (out >= 0 ? line[out] : 0);
+        }
+    }
+}
+
+} // namespace
+
+namespace ShadowSprite {
+
+qreal extent(qreal blurRadius) {
+    return blurRadius;
+}
+
+QPixmap sprite(qreal cornerRadius, qreal blurRadius, const QColor& color, qreal devicePixelRatio) {
+    static QHash<SpriteKey, QPixmap> cache; // UI thread only
+
+    const SpriteKey key{qRound(cornerRadius), qRound(blurRadius), color.rgba(),
+                        qRound(devicePixelRatio * 100)};
+    const auto found = cache.constFind(key);
+    if (found != cache.constEnd()) {
+        return *found;
+    }
+
+    // Corners plus a one pixel stretchable middle, in logical pixels
+    const qreal margin = extent(blurRadius) + cornerRadius;
+    const qreal side = 2 * margin + 1;
+
+    QImage image(qCeil(side * devicePixelRatio), qCeil(side * devicePixelRatio),
+                 QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.scale(devicePixelRatio, devicePixelRatio);
+        const qreal inset = extent(blurRadius);
+        QPainterPath shape;
+        shape.addRoundedRect(QRectF(inset, inset, side - 2 * inset, side - 2 * inset),
+                             cornerRadius, cornerRadius);
+        painter.fillPath(shape, Qt::black);
+    }
+
+    // Three box passes approximate a Gaussian that fades out at the blur radius
+    const int boxRadius = qMax(1, qRound(blurRadius * devicePixelRatio / 3));
+    for (int pass = 0; pass < 3; ++pass) {
+        boxBlurAlpha(image, boxRadius);
+    }
+
+    // Tint: the blurred alpha becomes coverage of the shadow color
+    {
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        painter.fillRect(image.rect(), color);
+    }
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    cache.insert(key, pixmap);
+    return pixmap;
+}
+
+void draw(QPainter& painter, const QRectF& rect, qreal cornerRadius, qreal blurRadius,
+          const QColor& color) {
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatioF() : 1;
+    const QPixmap shadow = sprite(cornerRadius, blurRadius, color, dpr);
+
+    const qreal spread = extent(blurRadius);
+    const int margin = qRound(spread + cornerRadius);
+    const QMargins margins(margin, margin, margin, margin);
+    const QRect target = rect.adjusted(-spread, -spread, spread, spread).toAlignedRect();
+    qDrawBorderPixmap(&painter, target, margins, shadow);
+}
+
+} // namespace ShadowSprite
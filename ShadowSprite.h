@@ -0,0 +1,36 @@
+#ifndef SHADOWSPRITE_H
+#define SHADOWSPRITE_H
+
+#include <QColor>
+#include <QPixmap>
+
+class QPainter;
+class QRectF;
+
+/*
+ Soft drop shadows without a per-frame blur.
+
+ The shadow of a rounded rect is a nine-patch: four blurred corners, four
+ edges that are the same blurred profile stretched, and a flat middle. So
+ the blur runs once per corner radius, blur radius, color and device pixel
+ ratio, on a sprite just big enough for the corners, and drawing a shadow
+ of any size afterwards is nine pixmap blits.
+*/
+namespace ShadowSprite {
+
+// Same look as QGraphicsDropShadowEffect's defaults
+inline const QColor DEFAULT_COLOR{63, 63, 63, 180};
+
+// How far the shadow reaches past the shape it is cast by
+qreal extent(qreal blurRadius);
+
+// Draws the shadow of a rounded rect with the painter's current transform
+void draw(QPainter& painter, const QRectF& rect, qreal cornerRadius, qreal blurRadius,
+          const QColor& color = DEFAULT_COLOR);
+
+// The cached sprite itself, built on first use
+QPixmap sprite(qreal cornerRadius, qreal blurRadius, const QColor& color, qreal devicePixelRatio);
+
+} // namespace ShadowSprite
+
+#endif // SHADOWSPRITE_H
@@ -0,0 +1,290 @@
+#ifndef SLOTRULES_H
+#define SLOTRULES_H
+
+#include <array>
+#include <cstdint>
+
+// Symbols on the reels, in the order the original m_symbols list used
+enum class Symbol : std::uint8_t {
+    Cherry,
+    Bell,
+    Lemon,
+    Orange,
+    Star,
+    Skull
+};
+
+constexpr int SYMBOL_COUNT = 6;
+// The classic machine; the rules below work for any number of reels
+constexpr int REEL_COUNT = 3;
+
+// The symbols along one payline, left to right
+template <int ReelCount>
+using LineSymbols = std::array<Symbol, ReelCount>;
+
+using Reels = LineSymbols<REEL_COUNT>;
+
+constexpr std::array<const char*, SYMBOL_COUNT> SYMBOL_NAMES{
+    "Cherry", "Bell", "Lemon", "Orange", "Star", "Skull"
+};
+
+constexpr std::array<const char*, SYMBOL_COUNT> SYMBOL_EMOJIS{
+    "🍒", "🔔", "🍋", "🍊", "⭐", "💀"
+};
+
+constexpr const char* symbolName(Symbol symbol) {
+    return SYMBOL_NAMES[static_cast<int>(symbol)];
+}
+
+constexpr const char* symbolEmoji(Symbol symbol) {
+    return SYMBOL_EMOJIS[static_cast<int>(symbol)];
+}
+
+// What a single payline resolved to, in the priority order the rules check them
+enum class Outcome : std::uint8_t {
+    Loss,         // Nothing matched, only the stake is lost
+    Pair,         // Two of a kind with no skulls
+    ThreeOfAKind, // Every reel matching, other than on Bell or Skull
+    Jackpot,      // Bells on every reel
+    TwoSkulls,    // Fixed penalty, floored at zero
+    ThreeSkulls   // Balance wiped
+};
+
+constexpr int OUTCOME_COUNT = 6;
+
+constexpr bool isWin(Outcome outcome) {
+    return outcome == Outcome::Pair || outcome == Outcome::ThreeOfAKind || outcome == Outcome::Jackpot;
+}
+
+// All amounts are in pence; the cost is per payline played
+struct Paytable {
+    int cost{20};
+    int jackpot{500};
+    int threeOfAKind{100};
+    int pair{50};
+    int twoSkullPenalty{100};
+    bool threeSkullsWipe{true}; // Otherwise three skulls cost the two-skull penalty
+};
+
+constexpr bool operator==(const Paytable& a, const Paytable& b) {
+    return a.cost == b.cost && a.jackpot == b.jackpot && a.threeOfAKind == b.threeOfAKind &&
+           a.pair == b.pair && a.twoSkullPenalty == b.twoSkullPenalty &&
+           a.threeSkullsWipe == b.threeSkullsWipe;
+}
+constexpr bool operator!=(const Paytable& a, const Paytable& b) { return !(a == b); }
+
+template <int ReelCount>
+constexpr bool allMatch(const LineSymbols<ReelCount>& line) {
+    for (int i = 1; i < ReelCount; ++i) {
+        if (line[i] != line[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int ReelCount>
+constexpr bool hasPair(const LineSymbols<ReelCount>& line) {
+    for (int i = 0; i < ReelCount; ++i) {
+        for (int j = i + 1; j < ReelCount; ++j) {
+            if (line[i] == line[j]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+constexpr bool hasThreeOfAKind(const Reels& reels) {
+    return allMatch<REEL_COUNT>(reels);
+}
+
+constexpr bool hasTwoOfAKind(const Reels& reels) {
+    return hasPair<REEL_COUNT>(reels);
+}
+
+template <int ReelCount>
+constexpr int countSymbol(const LineSymbols<ReelCount>& line, Symbol symbol) {
+    int count = 0;
+    for (Symbol reel : line) {
+        count += reel == symbol ? 1 : 0;
+    }
+    return count;
+}
+
+template <int ReelCount>
+constexpr Outcome classifyLine(const LineSymbols<ReelCount>& line) {
+    // Check for skulls first (losses)
+    const int skullCount = countSymbol<ReelCount>(line, Symbol::Skull);
+    if (skullCount >= 3) {
+        return Outcome::ThreeSkulls;
+    }
+    if (skullCount == 2) {
+        return Outcome::TwoSkulls;
+    }
+
+    // Check for wins
+    if (allMatch<ReelCount>(line)) {
+        return line[0] == Symbol::Bell ? Outcome::Jackpot : Outcome::ThreeOfAKind;
+    }
+    if (hasPair<ReelCount>(line) && skullCount == 0) {
+        return Outcome::Pair;
+    }
+    return Outcome::Loss;
+}
+
+constexpr Outcome classify(const Reels& reels) {
+    return classifyLine<REEL_COUNT>(reels);
+}
+
+constexpr int symbolCombinations(int reelCount) {
+    int combinations = 1;
+    for (int i = 0; i < reelCount; ++i) {
+        combinations *= SYMBOL_COUNT;
+    }
+    return combinations;
+}
+
+// Every possible payline, one table entry each: 216 for three reels, 7776 for five
+template <int ReelCount>
+constexpr int LINE_TABLE_SIZE = symbolCombinations(ReelCount);
+
+constexpr int OUTCOME_TABLE_SIZE = LINE_TABLE_SIZE<REEL_COUNT>;
+
+// Index of a payline in the line table, the first reel most significant
+template <int ReelCount>
+constexpr int lineIndex(const LineSymbols<ReelCount>& line) {
+    int index = 0;
+    for (Symbol symbol : line) {
+        index = index * SYMBOL_COUNT + static_cast<int>(symbol);
+    }
+    return index;
+}
+
+template <int ReelCount>
+constexpr LineSymbols<ReelCount> lineFromIndex(int index) {
+    LineSymbols<ReelCount> line{};
+    for (int i = ReelCount - 1; i >= 0; --i) {
+        line[i] = static_cast<Symbol>(index % SYMBOL_COUNT);
+        index /= SYMBOL_COUNT;
+    }
+    return line;
+}
+
+// Index of a reel combination in the outcome table
+constexpr int outcomeIndex(Symbol a, Symbol b, Symbol c) {
+    return (static_cast<int>(a) * SYMBOL_COUNT + static_cast<int>(b)) * SYMBOL_COUNT + static_cast<int>(c);
+}
+
+constexpr int outcomeIndex(const Reels& reels) {
+    return lineIndex<REEL_COUNT>(reels);
+}
+
+constexpr Reels reelsFromIndex(int index) {
+    return lineFromIndex<REEL_COUNT>(index);
+}
+
+// Resolved outcome of one payline. The payout is added after the stake is
+// taken and the result floored at zero; a wipe zeroes the balance.
+struct OutcomeEntry {
+    std::int16_t payout{0};
+    Outcome outcome{Outcome::Loss};
+    bool wipe{false};
+};
+
+constexpr int payoutFor(Outcome outcome, const Paytable& paytable) {
+    switch (outcome) {
+        case Outcome::Jackpot:
+            return paytable.jackpot;
+        case Outcome::ThreeOfAKind:
+            return paytable.threeOfAKind;
+        case Outcome::Pair:
+            return paytable.pair;
+        case Outcome::TwoSkulls:
+            return -paytable.twoSkullPenalty;
+        case Outcome::ThreeSkulls:
+            return paytable.threeSkullsWipe ? 0 : -paytable.twoSkullPenalty;
+        case Outcome::Loss:
+            break;
+    }
+    return 0;
+}
+
+template <int ReelCount>
+using LineTable = std::array<OutcomeEntry, LINE_TABLE_SIZE<ReelCount>>;
+
+template <int ReelCount>
+constexpr LineTable<ReelCount> makeLineTable(const Paytable& paytable) {
+    LineTable<ReelCount> table{};
+    for (int i = 0; i < LINE_TABLE_SIZE<ReelCount>; ++i) {
+        const Outcome outcome = classifyLine<ReelCount>(lineFromIndex<ReelCount>(i));
+        table[i].outcome = outcome;
+        table[i].payout = static_cast<std::int16_t>(payoutFor(outcome, paytable));
+        table[i].wipe = outcome == Outcome::ThreeSkulls && paytable.threeSkullsWipe;
+    }
+    return table;
+}
+
+using OutcomeTable = LineTable<REEL_COUNT>;
+
+constexpr OutcomeTable makeOutcomeTable(const Paytable& paytable) {
+    return makeLineTable<REEL_COUNT>(paytable);
+}
+
+// Balance after the stake has been taken and the payouts of every line added
+constexpr int applyPayout(int money, int stake, int payout, bool wipe) {
+    const int settled = money - stake + payout;
+    return wipe || settled < 0 ? 0 : settled;
+}
+
+// Balance after the stake has been taken and the outcome applied
+constexpr int applyOutcome(int money, int cost, const OutcomeEntry& entry) {
+    return applyPayout(money, cost, entry.payout, entry.wipe);
+}
+
+inline constexpr OutcomeTable DEFAULT_OUTCOME_TABLE = makeOutcomeTable(Paytable{});
+
+namespace detail {
+
+// Straight port of the branches that used to live in MainWindow::onSpinButtonClicked,
+// kept only to check the table against
+constexpr int referenceBalance(int money, const Reels& reels) {
+    int skullCount = 0;
+    for (Symbol reel : reels) {
+        skullCount += reel == Symbol::Skull ? 1 : 0;
+    }
+    money -= 20;
+    if (skullCount >= 3) {
+        return 0;
+    } else if (skullCount == 2) {
+        return money - 100 > 0 ? money - 100 : 0;
+    } else if (reels[0] == reels[1] && reels[1] == reels[2]) {
+        return money + (reels[0] == Symbol::Bell ? 500 : 100);
+    } else if ((reels[0] == reels[1] || reels[1] == reels[2] || reels[0] == reels[2]) && skullCount == 0) {
+        return money + 50;
+    }
+    return money;
+}
+
+constexpr bool verifyOutcomeTable() {
+    constexpr int balances[] = {20, 39, 100, 119, 120, 121, 500, 100000};
+    for (int i = 0; i < OUTCOME_TABLE_SIZE; ++i) {
+        for (int money : balances) {
+            if (applyOutcome(money, 20, DEFAULT_OUTCOME_TABLE[i]) != referenceBalance(money, reelsFromIndex(i))) {
+                return false;
+            }
+        }
+        if (outcomeIndex(reelsFromIndex(i)) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+static_assert(detail::verifyOutcomeTable(), "Outcome table does not match the payout rules");
+static_assert(DEFAULT_OUTCOME_TABLE[outcomeIndex(Symbol::Bell, Symbol::Bell, Symbol::Bell)].outcome == Outcome::Jackpot);
+static_assert(DEFAULT_OUTCOME_TABLE[outcomeIndex(Symbol::Cherry, Symbol::Skull, Symbol::Cherry)].outcome == Outcome::Loss);
+
+#endif // SLOTRULES_H
@@ -0,0 +1,16 @@
+#include "SpinEngine.h"
+
+#include <random>
+
+namespace detail {
+
+std::uint64_t randomSeed() {
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+}
+
+} // namespace detail
+
+// Built once here rather than in every file that spins
+template class BasicSpinEngine<REEL_COUNT, 1, SingleLine<REEL_COUNT>>;
+template class BasicSpinEngine<5, 3, TwentyLines>;
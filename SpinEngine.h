@@ -0,0 +1,318 @@
+#ifndef SPINENGINE_H
+#define SPINENGINE_H
+
+#include "Paylines.h"
+#include "ReelStrips.h"
+#include "Rng.h"
+#include "SlotRules.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Generator behind every spin, swap here to plug in another engine
+using SpinRng = Xoshiro256StarStar;
+
+// Everything that gets persisted between runs, amounts in pence
+struct GameState {
+    // Current game state
+    int money{100};
+    int spinCount{0};
+    int maxMoney{100}; // Tracks highest amount of money held
+    // Overall statistics
+    int highestSpin{0};
+    int totalSpins{0};
+    int totalMoneyEarnt{0};
+    int allTimeHighestMoney{0};
+    int runsPlayed{0};
+};
+
+inline bool operator==(const GameState& a, const GameState& b) {
+    return a.money == b.money && a.spinCount == b.spinCount && a.maxMoney == b.maxMoney &&
+           a.highestSpin == b.highestSpin && a.totalSpins == b.totalSpins &&
+           a.totalMoneyEarnt == b.totalMoneyEarnt && a.allTimeHighestMoney == b.allTimeHighestMoney &&
+           a.runsPlayed == b.runsPlayed;
+}
+inline bool operator!=(const GameState& a, const GameState& b) { return !(a == b); }
+
+// The visible symbols, window[row][reel]
+template <int ReelCount, int RowCount>
+using SymbolWindow = std::array<LineSymbols<ReelCount>, RowCount>;
+
+template <int ReelCount, int RowCount>
+struct BasicSpinResult {
+    SymbolWindow<ReelCount, RowCount> window{};
+    BasicReelStops<ReelCount> stops{}; // Stop index on each reel strip
+    Outcome outcome{Outcome::Loss};    // The most severe outcome over all lines
+    std::uint32_t winningLines{0};     // Bit per payline that paid out
+    int delta{0};                      // Balance change including the stake
+};
+
+struct BatchResult {
+    std::uint64_t spins{0};
+    std::uint64_t wins{0};
+    std::int64_t wagered{0};
+    std::int64_t returned{0}; // Sum of (delta + stake) over every spin
+    double returnedSquares{0}; // Sum of (delta + stake)^2, for variance
+    std::array<std::uint64_t, OUTCOME_COUNT> outcomes{};
+    bool bust{false};         // Stopped early because the balance fell below the stake
+};
+
+namespace detail {
+
+std::uint64_t randomSeed();
+
+} // namespace detail
+
+/*
+ Headless fruit machine: symbol set, RNG, payout rules and balance accounting.
+ Has no Qt dependency so it can be driven by the GUI, simulators and benchmarks alike.
+
+ The layout is a template: ReelCount reels showing RowCount rows, played on
+ every line of the Paylines set (see Paylines.h) for the paytable cost per
+ line. Each line is looked up in a table of every possible line, and the
+ lookups are unrolled at compile time over the fixed payline rows, so a
+ given layout runs as straight-line code. The classic game is SpinEngine,
+ three reels, one row, one line.
+*/
+template <int ReelCount, int RowCount, typename Paylines>
+class BasicSpinEngine {
+    static_assert(ReelCount >= 3, "The rules need at least three reels");
+    static_assert(RowCount >= 1, "A machine shows at least one row");
+    static_assert(Paylines::COUNT >= 1 && Paylines::COUNT <= 32, "Winning lines are reported as 32-bit masks");
+    static_assert(std::tuple_size<typename decltype(Paylines::ROWS)::value_type>::value == ReelCount,
+                  "Paylines are for a different number of reels");
+
+public:
+    static constexpr int REELS = ReelCount;
+    static constexpr int ROWS = RowCount;
+    static constexpr int LINES = Paylines::COUNT;
+
+    using Window = SymbolWindow<ReelCount, RowCount>;
+    using Stops = BasicReelStops<ReelCount>;
+    using Result = BasicSpinResult<ReelCount, RowCount>;
+    using ReelSetType = BasicReelSet<ReelCount>;
+
+    BasicSpinEngine() : BasicSpinEngine(detail::randomSeed()) {}
+    explicit BasicSpinEngine(std::uint64_t seed) { reseed(seed); }
+
+    // The RNG position is fully described by the seed and the number of
+    // outputs drawn since, which is what gets written to the save file.
+    // Restoring it jumps straight there, however long the save has been played.
+    std::uint64_t seed() const { return m_seed; }
+    std::uint64_t draws() const { return m_rng.draws; }
+    void reseed(std::uint64_t seed, std::uint64_t draws = 0) {
+        m_seed = seed;
+        m_rng.rng = SpinRng(seed);
+        m_rng.rng.discard(draws);
+        m_rng.draws = draws;
+    }
+    // Hand the engine an independent stream, e.g. one produced with SpinRng::jump()
+    void setRng(const SpinRng& rng) {
+        m_rng.rng = rng;
+        m_rng.draws = 0;
+    }
+
+    const GameState& state() const { return m_state; }
+    void setState(const GameState& state) { m_state = state; }
+    const Paytable& paytable() const { return m_paytable; }
+    void setPaytable(const Paytable& paytable) {
+        m_paytable = paytable;
+        m_lines = makeLineTable<ReelCount>(paytable);
+    }
+    // Takes a line table already compiled from the paytable, e.g. by loadPaytable()
+    void setPaytable(const Paytable& paytable, const LineTable<ReelCount>& lines) {
+        m_paytable = paytable;
+        m_lines = lines;
+    }
+    const ReelSetType& reelStrips() const { return m_reels.reels(); }
+    // Rebuilds the alias tables; returns false and keeps the old strips if invalid
+    bool setReelStrips(const ReelSetType& reels, std::string* error = nullptr) {
+        if (!validateReels(reels, error)) {
+            return false;
+        }
+        m_reels = BasicReelSampler<ReelCount>(reels);
+        return true;
+    }
+
+    // Cost of one spin, every line played
+    int stake() const { return m_paytable.cost * LINES; }
+    bool canSpin() const { return m_state.money >= stake(); }
+
+    Window rollReels() {
+        Stops stops;
+        Window window;
+        roll(stops, window);
+        return window;
+    }
+
+    Result spin() {
+        FMCHNE_TRACE_SCOPE("SpinEngine::spin");
+        Result result;
+        if (!canSpin()) {
+            return result;
+        }
+        const LineTotal total = roll(result.stops, result.window);
+        result.outcome = total.outcome;
+        result.winningLines = total.winningLines;
+        result.delta = settle(total);
+        return result;
+    }
+
+    BatchResult spin(std::uint64_t count) {
+        FMCHNE_TRACE_SCOPE("SpinEngine::spinBatch");
+        BatchResult batch;
+        Stops stops;
+        Window window;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (!canSpin()) {
+                batch.bust = true;
+                break;
+            }
+            const LineTotal total = roll(stops, window);
+            const int delta = settle(total);
+
+            const int returned = delta + stake();
+            batch.spins++;
+            batch.wagered += stake();
+            batch.returned += returned;
+            batch.returnedSquares += static_cast<double>(returned) * returned;
+            batch.outcomes[static_cast<int>(total.outcome)]++;
+            if (total.winningLines != 0) {
+                batch.wins++;
+            }
+        }
+        return batch;
+    }
+
+    void beginRun() {
+        m_state.runsPlayed += 1;
+    }
+
+    void resetRun() {
+        m_state.money = 100;
+        m_state.spinCount = 0;
+        m_state.maxMoney = 100;
+    }
+
+    void claim() {
+        m_state.maxMoney = std::max(m_state.maxMoney, m_state.money);
+    }
+
+private:
+    struct CountedRng {
+        using result_type = SpinRng::result_type;
+        SpinRng rng;
+        std::uint64_t draws{0};
+        result_type operator()() { ++draws; return rng(); }
+    };
+
+    struct LineTotal {
+        int payout{0};
+        bool wipe{false};
+        Outcome outcome{Outcome::Loss};
+        std::uint32_t winningLines{0};
+
+        void add(int line, const OutcomeEntry& entry) {
+            payout += entry.payout;
+            wipe = wipe || entry.wipe;
+            outcome = std::max(outcome, entry.outcome);
+            winningLines |= isWin(entry.outcome) ? std::uint32_t{1} << line : 0;
+        }
+    };
+
+    // One row and one line: the line is the whole window, so the combination
+    // drawn for uniform reels is already its table index
+    static constexpr bool DIRECT_LINE = RowCount == 1 && LINES == 1;
+
+    // Table index of one payline, its row on every reel known at compile time
+    template <int Line, std::size_t... Reel>
+    static int lineIndexAt(const Window& window, std::index_sequence<Reel...>) {
+        int index = 0;
+        ((index = index * SYMBOL_COUNT + static_cast<int>(window[Paylines::ROWS[Line][Reel]][Reel])), ...);
+        return index;
+    }
+
+    template <std::size_t... Line>
+    LineTotal evaluate(const Window& window, std::index_sequence<Line...>) const {
+        LineTotal total;
+        (total.add(static_cast<int>(Line),
+                   m_lines[lineIndexAt<static_cast<int>(Line)>(window, std::make_index_sequence<ReelCount>{})]), ...);
+        return total;
+    }
+
+    LineTotal roll(Stops& stops, Window& window) {
+        {
+            // Drawing the reels, what generateRandomSymbol() used to do, apart from scoring them
+            FMCHNE_TRACE_SCOPE("SpinEngine::rollReels");
+            if (m_reels.isUniform()) {
+                // One draw picks the stops of every reel at once
+                int combination = static_cast<int>(m_combination(m_rng));
+                if constexpr (DIRECT_LINE) {
+                    const LineSymbols<ReelCount> line = lineFromIndex<ReelCount>(combination);
+                    for (int r = 0; r < ReelCount; ++r) {
+                        stops[r] = static_cast<std::uint16_t>(line[r]);
+                    }
+                    window[0] = line;
+                    LineTotal total;
+                    total.add(0, m_lines[combination]);
+                    return total;
+                }
+                for (int r = ReelCount - 1; r >= 0; --r) {
+                    stops[r] = static_cast<std::uint16_t>(combination % SYMBOL_COUNT);
+                    combination /= SYMBOL_COUNT;
+                }
+            } else {
+                m_reels.roll(m_rng, stops);
+            }
+
+            for (int row = 0; row < RowCount; ++row) {
+                for (int r = 0; r < ReelCount; ++r) {
+                    window[row][r] = m_reels.symbolAt(r, stops[r], row);
+                }
+            }
+        }
+        return evaluate(window, std::make_index_sequence<LINES>{});
+    }
+
+    int settle(const LineTotal& total) {
+        const int previousMoney = m_state.money;
+
+        m_state.spinCount++;
+        m_state.totalSpins++;
+        m_state.highestSpin = std::max(m_state.spinCount, m_state.highestSpin);
+
+        m_state.money = applyPayout(m_state.money, stake(), total.payout, total.wipe);
+
+        m_state.maxMoney = std::max(m_state.maxMoney, m_state.money);
+        m_state.allTimeHighestMoney = std::max(m_state.money, m_state.allTimeHighestMoney);
+        if (m_state.money > previousMoney) {
+            m_state.totalMoneyEarnt += m_state.money - previousMoney;
+        }
+        return m_state.money - previousMoney;
+    }
+
+    GameState m_state;
+    Paytable m_paytable;
+    LineTable<ReelCount> m_lines{makeLineTable<ReelCount>(Paytable{})};
+    std::uint64_t m_seed{0};
+    CountedRng m_rng;
+    BasicReelSampler<ReelCount> m_reels;
+    // While every reel is uniform one draw picks the whole combination
+    BoundedSampler m_combination{static_cast<std::uint32_t>(LINE_TABLE_SIZE<ReelCount>)};
+};
+
+// The original machine
+using SpinEngine = BasicSpinEngine<REEL_COUNT, 1, SingleLine<REEL_COUNT>>;
+using SpinResult = SpinEngine::Result;
+
+// Five reels, three rows, twenty lines
+using FiveByThreeEngine = BasicSpinEngine<5, 3, TwentyLines>;
+
+extern template class BasicSpinEngine<REEL_COUNT, 1, SingleLine<REEL_COUNT>>;
+extern template class BasicSpinEngine<5, 3, TwentyLines>;
+
+#endif // SPINENGINE_H
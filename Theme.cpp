@@ -0,0 +1,123 @@
+#include "Theme.h"
+
+#include <QApplication>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QPushButton>
+#include <QStyleFactory>
+#include <QStyleOptionButton>
+
+namespace {
+
+constexpr qreal BUTTON_RADIUS = 10;
+const char *const ROLE_PROPERTY = "themeRole";
+
+const char *roleName(Theme::Role role) {
+    switch (role) {
+        case Theme::Role::Background: return "background";
+        case Theme::Role::Frame: return "frame";
+        case Theme::Role::Title: return "title";
+        case Theme::Role::Stats: return "stats";
+    }
+    return "";
+}
+
+// Everything except buttons; ThemeStyle draws those
+const char *const ROLE_STYLESHEET =
+    "QWidget[themeRole=\"background\"], QLabel[themeRole=\"title\"] {"
+    "   background-color: qlineargradient(y1: 0, y2: 1, "
+    "stop: 0 #1a001a, stop: 0.5 #330033, stop: 1 #4d004d);"
+    "   border: 2px solid #FFD700;"
+    "}"
+    "QLabel[themeRole=\"title\"] {"
+    "   color: #FFD700;"
+    "}"
+    "QWidget[themeRole=\"frame\"] {"
+    "   background-color: qlineargradient(y1: 0, y2: 1, "
+    "stop: 0 #8B0000, stop: 1 #FF4500);"
+    "   border-radius: 20px;"
+    "   border: 5px solid #FFD700;"
+    "}"
+    "QLabel[themeRole=\"stats\"] {"
+    "   color: #FFD700;"
+    "   background-color: rgba(0, 0, 0, 100);"
+    "   border: 2px solid #FFD700;"
+    "   border-radius: 15px;"
+    "   padding: 20px;"
+    "}";
+
+} // namespace
+
+ThemeStyle::ThemeStyle()
+    : QProxyStyle(QStyleFactory::create("Fusion"))
+    , m_border(QColor("#FFD700"), 2)
+{
+    // Gradient runs top to bottom over whatever rect it fills
+    QLinearGradient gold(0, 0, 0, 1);
+    gold.setCoordinateMode(QGradient::ObjectBoundingMode);
+    gold.setColorAt(0, QColor("#FFD700"));
+    gold.setColorAt(1, QColor("#FF8C00"));
+
+    m_default = {QBrush(gold), Qt::black};
+    m_hover = {QBrush(QColor("#FF6347")), Qt::black};
+    m_pressed = {QBrush(QColor("#FF4500")), Qt::white};
+
+    m_font.setPixelSize(20);
+    m_font.setBold(true);
+}
+
+void ThemeStyle::polish(QWidget *widget) {
+    QProxyStyle::polish(widget);
+    if (qobject_cast<QPushButton *>(widget)) {
+        // Hover state has to reach the style option for the hover look
+        widget->setAttribute(Qt::WA_Hover);
+        widget->setFont(m_font);
+    }
+}
+
+const ThemeStyle::ButtonLook &ThemeStyle::lookFor(QStyle::State state) const {
+    if (state & State_Sunken) {
+        return m_pressed;
+    }
+    if (state & State_MouseOver) {
+        return m_hover;
+    }
+    return m_default;
+}
+
+void ThemeStyle::drawControl(ControlElement element, const QStyleOption *option,
+                             QPainter *painter, const QWidget *widget) const {
+    const auto *buttonOption = qstyleoption_cast<const QStyleOptionButton *>(option);
+    if (element != CE_PushButton || !buttonOption) {
+        QProxyStyle::drawControl(element, option, painter, widget);
+        return;
+    }
+
+    const ButtonLook &look = lookFor(buttonOption->state);
+    const qreal inset = m_border.widthF() / 2;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(m_border);
+    painter->setBrush(look.fill);
+    painter->drawRoundedRect(QRectF(buttonOption->rect).adjusted(inset, inset, -inset, -inset),
+                             BUTTON_RADIUS, BUTTON_RADIUS);
+
+    painter->setPen(look.text);
+    painter->setFont(widget ? widget->font() : m_font);
+    painter->drawText(buttonOption->rect, Qt::AlignCenter, buttonOption->text);
+    painter->restore();
+}
+
+namespace Theme {
+
+void install(QApplication &app) {
+    app.setStyle(new ThemeStyle);
+    app.setStyleSheet(ROLE_STYLESHEET);
+}
+
+void setRole(QWidget *widget, Role role) {
+    widget->setProperty(ROLE_PROPERTY, roleName(role));
+}
+
+} // namespace Theme
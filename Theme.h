@@ -0,0 +1,62 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QPen>
+#include <QProxyStyle>
+
+class QApplication;
+
+/*
+ Visual theme for the whole app, built once at startup.
+
+ Buttons are drawn by ThemeStyle from brushes and pens prepared in its
+ constructor; which look is used comes from the style option state
+ (hovered, pressed), so entering, leaving or pressing a button is just a
+ repaint. Backgrounds and labels are tagged with a role property and
+ styled by one application stylesheet, parsed once in Theme::install().
+*/
+class ThemeStyle : public QProxyStyle {
+    Q_OBJECT
+
+public:
+    ThemeStyle();
+
+    void polish(QWidget *widget) override;
+    void drawControl(ControlElement element, const QStyleOption *option,
+                     QPainter *painter, const QWidget *widget = nullptr) const override;
+
+private:
+    struct ButtonLook {
+        QBrush fill;
+        QColor text;
+    };
+
+    const ButtonLook &lookFor(QStyle::State state) const;
+
+    ButtonLook m_default;
+    ButtonLook m_hover;
+    ButtonLook m_pressed;
+    QPen m_border;
+    QFont m_font;
+};
+
+namespace Theme {
+
+enum class Role {
+    Background,
+    Frame,
+    Title,
+    Stats
+};
+
+// Installs ThemeStyle and the role stylesheet; call once, before any widget exists
+void install(QApplication &app);
+// Tags a widget for the role stylesheet; set before the widget is first shown
+void setRole(QWidget *widget, Role role);
+
+} // namespace Theme
+
+#endif // THEME_H
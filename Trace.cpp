@@ -0,0 +1,177 @@
+#include "Trace.h"
+
+#ifdef FMCHNE_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    std::uint64_t startNs;
+    std::uint64_t durationNs;
+};
+
+// Filled only by its thread; count is published with release so a reader on
+// another thread sees whole events. Chunks are linked the same way.
+struct Chunk {
+    static constexpr std::size_t CAPACITY = 4096;
+    Event events[CAPACITY];
+    std::atomic<std::size_t> count{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer {
+    // A runaway loop (say, a simulation) stops recording here instead of eating memory
+    static constexpr std::size_t MAX_CHUNKS = 256;
+
+    int id{0};
+    std::atomic<const char*> name{nullptr};
+    Chunk first;
+    Chunk* last{&first};
+    std::size_t chunks{1};
+    std::atomic<std::uint64_t> dropped{0};
+    std::vector<std::unique_ptr<Chunk>> owned;
+
+    void append(const Event& event) {
+        std::size_t count = last->count.load(std::memory_order_relaxed);
+        if (count == Chunk::CAPACITY) {
+            if (chunks == MAX_CHUNKS) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            owned.push_back(std::make_unique<Chunk>());
+            Chunk* chunk = owned.back().get();
+            last->next.store(chunk, std::memory_order_release);
+            last = chunk;
+            chunks++;
+            count = 0;
+        }
+        last->events[count] = event;
+        last->count.store(count + 1, std::memory_order_release);
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    // Never freed: a thread's spans outlive the thread
+    std::vector<ThreadBuffer*> buffers;
+    std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = [] {
+        auto* created = new ThreadBuffer;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        created->id = static_cast<int>(reg.buffers.size()) + 1;
+        reg.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+// Trace names are identifiers and literals, but quote defensively
+void writeJsonString(std::FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+        }
+        std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+namespace Trace {
+
+std::uint64_t nowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry().epoch).count());
+}
+
+void record(const char* name, std::uint64_t startNs, std::uint64_t endNs) {
+    threadBuffer().append({name, startNs, endNs - startNs});
+}
+
+void setThreadName(const char* name) {
+    threadBuffer().name.store(name, std::memory_order_release);
+}
+
+bool writeChromeJson(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffers = reg.buffers;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    bool first = true;
+    for (const ThreadBuffer* buffer : buffers) {
+        if (const char* name = buffer->name.load(std::memory_order_acquire)) {
+            std::fprintf(file, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                         first ? "" : ",", buffer->id);
+            writeJsonString(file, name);
+            std::fputs("}}", file);
+            first = false;
+        }
+
+        for (const Chunk* chunk = &buffer->first; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const std::size_t count = chunk->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i) {
+                const Event& event = chunk->events[i];
+                // Timestamps are microseconds; keep the nanoseconds as decimals
+                std::fprintf(file, "%s\n{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                             first ? "" : ",", buffer->id, event.startNs / 1000.0, event.durationNs / 1000.0);
+                writeJsonString(file, event.name);
+                std::fputc('}', file);
+                first = false;
+            }
+        }
+
+        const std::uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::fprintf(file, "%s\n{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,"
+                               "\"name\":\"dropped %llu spans\"}",
+                         first ? "" : ",", buffer->id, nowNs() / 1000.0,
+                         static_cast<unsigned long long>(dropped));
+            first = false;
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+} // namespace Trace
+
+#else
+
+namespace Trace {
+
+void setThreadName(const char*) {}
+
+bool writeChromeJson(const std::string&) {
+    return false;
+}
+
+} // namespace Trace
+
+#endif
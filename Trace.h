@@ -0,0 +1,66 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+/*
+ Scoped span tracing, exported as Chrome trace-event JSON (chrome://tracing,
+ ui.perfetto.dev).
+
+   FMCHNE_TRACE_SCOPE("SaveJournal::append");
+
+ records one complete event from that line to the end of the scope. Each
+ thread appends to its own buffer with no locks; only a thread's first
+ span takes a mutex to register it. Names must be string literals, since
+ only the pointer is stored.
+
+ Tracing only exists in builds configured with FMCHNE_TRACING. Otherwise
+ the macro expands to nothing and the functions below are empty, so
+ instrumented code costs exactly what it did without the spans.
+*/
+namespace Trace {
+
+constexpr bool compiledIn() {
+#ifdef FMCHNE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Label for the calling thread in the exported trace
+void setThreadName(const char* name);
+// Writes every span recorded so far, from all threads; false if tracing is
+// compiled out or the file cannot be written
+bool writeChromeJson(const std::string& path);
+
+#ifdef FMCHNE_TRACING
+std::uint64_t nowNs();
+void record(const char* name, std::uint64_t startNs, std::uint64_t endNs);
+
+class Scope {
+public:
+    explicit Scope(const char* name) : m_name(name), m_start(nowNs()) {}
+    ~Scope() { record(m_name, m_start, nowNs()); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* m_name;
+    std::uint64_t m_start;
+};
+#endif
+
+} // namespace Trace
+
+#ifdef FMCHNE_TRACING
+#define FMCHNE_TRACE_CONCAT_INNER(a, b) a##b
+#define FMCHNE_TRACE_CONCAT(a, b) FMCHNE_TRACE_CONCAT_INNER(a, b)
+#define FMCHNE_TRACE_SCOPE(name) ::Trace::Scope FMCHNE_TRACE_CONCAT(fmchneTraceScope, __LINE__)(name)
+#else
+#define FMCHNE_TRACE_SCOPE(name)
+#endif
+
+#endif // TRACE_H
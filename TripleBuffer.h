@@ -0,0 +1,42 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer mailbox that only ever holds
+// the newest value. The producer and consumer each own one slot and swap
+// it with the shared middle slot, so neither side ever waits and a burst
+// of publishes collapses into the last one.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    void publish(const T& value) {
+        m_slots[m_back] = value;
+        const std::uint8_t previous = m_middle.exchange(static_cast<std::uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // Consumer side; false if nothing was published since the last consume
+    bool consume(T& value) {
+        if (!(m_middle.load(std::memory_order_acquire) & FRESH)) {
+            return false;
+        }
+        const std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        value = m_slots[m_front];
+        return true;
+    }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4;
+
+    T m_slots[3]{};
+    std::uint8_t m_back{0};
+    std::atomic<std::uint8_t> m_middle{1};
+    std::uint8_t m_front{2};
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,144 @@
+#include "AllocationCounter.h"
+#include "ButtonAnimator.h"
+#include "RotatableButton.h"
+#include "SpinEngine.h"
+#include "mainwindow.h"
+
+#include <QDir>
+#include <QTemporaryDir>
+#include <QtTest>
+
+/*
+ Checks that a spin does no heap allocation once warmed up. Only meaningful
+ in builds configured with FMCHNE_COUNT_ALLOCATIONS, which replace the
+ global allocator; otherwise every test is skipped.
+
+ The spins are driven back to back within one frame. Asking Qt for the
+ next repaint posts an event, which allocates once per frame however many
+ spins land in it, so that is left out; everything the spin itself does is
+ counted. Button hover and press animations are retargeted in place and
+ must not allocate either, however they are interrupted.
+*/
+class FmchneAllocTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void engineSpin();
+    void spinButton();
+    void buttonRetarget();
+
+private:
+    QTemporaryDir m_workDir;
+};
+
+namespace {
+
+constexpr int WARMUP_SPINS = 64;
+constexpr int MEASURED_SPINS = 2000;
+constexpr int WARMUP_RETARGETS = 16;
+constexpr int MEASURED_RETARGETS = 2000;
+constexpr int SETTLE_EVERY = 500;  // Retarget cycles between letting the animations run out
+constexpr int SETTLE_MS = 250;     // Longer than the slowest animation
+
+GameState richState() {
+    GameState state;
+    state.money = 1'000'000;
+    return state;
+}
+
+} // namespace
+
+void FmchneAllocTest::initTestCase() {
+    if (!AllocationCounter::enabled()) {
+        QSKIP("Configure with -DFMCHNE_COUNT_ALLOCATIONS=ON to count allocations");
+    }
+    // MainWindow reads and writes its save in the working directory
+    QVERIFY(m_workDir.isValid());
+    QVERIFY(QDir::setCurrent(m_workDir.path()));
+}
+
+void FmchneAllocTest::engineSpin() {
+    SpinEngine engine(0x5EED);
+    engine.setState(richState());
+
+    const std::uint64_t before = AllocationCounter::threadCount();
+    for (int i = 0; i < MEASURED_SPINS; ++i) {
+        if (!engine.canSpin()) {
+            engine.setState(richState());
+        }
+        engine.spin();
+    }
+    QCOMPARE(AllocationCounter::threadCount() - before, std::uint64_t(0));
+}
+
+void FmchneAllocTest::spinButton() {
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    window.m_engine.setState(richState());
+    window.showScreen(MainWindow::Screen::Game);
+
+    // Fills the session log, the save mailbox and the label's glyph atlas
+    for (int i = 0; i < WARMUP_SPINS; ++i) {
+        window.onSpinButtonClicked();
+        QCoreApplication::processEvents();
+    }
+    window.onSpinButtonClicked();
+
+    int measured = 0;
+    for (int i = 0; i < MEASURED_SPINS; ++i) {
+        const std::uint64_t before = AllocationCounter::threadCount();
+        window.onSpinButtonClicked();
+        const std::uint64_t allocations = AllocationCounter::threadCount() - before;
+
+        // Three skulls end the run, and the end screen is not the spin path
+        if (!window.m_engine.canSpin()) {
+            window.m_engine.setState(richState());
+            window.showScreen(MainWindow::Screen::Game);
+            window.onSpinButtonClicked();
+            continue;
+        }
+        QCOMPARE(allocations, std::uint64_t(0));
+        measured++;
+    }
+    QVERIFY(measured > 0);
+}
+
+void FmchneAllocTest::buttonRetarget() {
+    RotatableButton button("Spin");
+    button.setButtonSize(QSize(180, 60));
+    auto* animator = new ButtonAnimator(&button);
+
+    // Hover and press both ways, each interrupting the last mid-flight
+    auto cycle = [animator]() {
+        animator->hoverEnter();
+        animator->press();
+        QCoreApplication::processEvents();
+        animator->release();
+        animator->hoverLeave();
+        QCoreApplication::processEvents();
+    };
+
+    // The first starts register the animations with Qt's animation timer
+    for (int i = 0; i < WARMUP_RETARGETS; ++i) {
+        cycle();
+    }
+    QTest::qWait(SETTLE_MS);
+
+    const std::uint64_t allocations = ButtonAnimator::retargetAllocations();
+    const std::uint64_t retargets = ButtonAnimator::retargetCount();
+    for (int i = 0; i < MEASURED_RETARGETS; ++i) {
+        cycle();
+        // Restarting a finished animation, not only redirecting a running one
+        if ((i + 1) % SETTLE_EVERY == 0) {
+            QTest::qWait(SETTLE_MS);
+        }
+    }
+    QCOMPARE(ButtonAnimator::retargetCount() - retargets, std::uint64_t(4 * MEASURED_RETARGETS));
+    QCOMPARE(ButtonAnimator::retargetAllocations() - allocations, std::uint64_t(0));
+}
+
+QTEST_MAIN(FmchneAllocTest)
+#include "fmchne_alloc_test.moc"
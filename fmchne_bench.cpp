@@ -0,0 +1,445 @@
+#include "BatchEvaluator.h"
+#include "RotatableButton.h"
+#include "SaveData.h"
+#include "SaveJournal.h"
+#include "SpinEngine.h"
+#include "Theme.h"
+#include "mainwindow.h"
+
+#include <QApplication>
+#include <QDir>
+#include <QEnterEvent>
+#include <QFile>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+#include <QXmlStreamReader>
+#include <QtTest>
+#include <cstdio>
+#include <vector>
+
+#ifndef FMCHNE_BENCH_DEFAULT_MARGIN
+#define FMCHNE_BENCH_DEFAULT_MARGIN 0.25
+#endif
+
+/*
+ Regression benchmarks for the hot paths of the game and its UI.
+
+ The QBENCHMARK results are read back from QtTest's XML log and written as
+ JSON (nanoseconds per iteration, keyed function or function:tag; the
+ batch evaluator is tagged with its SIMD level). Given --baseline they are
+ also compared with a baseline recorded on the same machine. Anything
+ slower than the baseline by more than the margin fails the run, and so
+ does a missing baseline; only --update-baseline writes one. Cases the
+ baseline has no entry for are reported but not judged. The margin is
+ --margin, else the FMCHNE_BENCH_MARGIN environment variable, else the
+ build's default.
+
+ fmchne_bench [-platform offscreen] [--baseline FILE] [--results FILE]
+              [--margin FRACTION] [--update-baseline] [QtTest options]
+*/
+class FmchneBench : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void spinEngine();
+    void spinEngineFiveByThree();
+    void batchEvaluate_data();
+    void batchEvaluate();
+    void rollReels();
+    void saveRoundTrip_data();
+    void saveRoundTrip();
+    void screenTransitions();
+    void rotatedPaint_data();
+    void rotatedPaint();
+    void hoverPaint_data();
+    void hoverPaint();
+    void updateMoneyLabel();
+
+private:
+    QTemporaryDir m_workDir;
+};
+
+void FmchneBench::initTestCase() {
+    // MainWindow reads and writes its save in the working directory
+    QVERIFY(m_workDir.isValid());
+    QVERIFY(QDir::setCurrent(m_workDir.path()));
+}
+
+void FmchneBench::spinEngine() {
+    SpinEngine engine(0x5EED);
+    GameState rich;
+    rich.money = 1'000'000;
+    engine.setState(rich);
+
+    QBENCHMARK {
+        if (!engine.canSpin()) {
+            engine.setState(rich);
+        }
+        engine.spin();
+    }
+}
+
+void FmchneBench::spinEngineFiveByThree() {
+    // Twenty unrolled line lookups per spin
+    FiveByThreeEngine engine(0x5EED);
+    GameState rich;
+    rich.money = 1'000'000;
+    engine.setState(rich);
+
+    QBENCHMARK {
+        if (!engine.canSpin()) {
+            engine.setState(rich);
+        }
+        engine.spin();
+    }
+}
+
+void FmchneBench::batchEvaluate_data() {
+    // One case per level this CPU runs, so the baseline is kept per level
+    QTest::addColumn<int>("level");
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse42, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (level <= detectSimdLevel()) {
+            QTest::newRow(simdLevelName(level)) << static_cast<int>(level);
+        }
+    }
+}
+
+void FmchneBench::batchEvaluate() {
+    QFETCH(int, level);
+    constexpr std::size_t SPINS = 4096;
+    SpinEngine engine(0x5EED);
+    std::vector<std::uint8_t> lanes[REEL_COUNT];
+    for (auto& lane : lanes) {
+        lane.resize(SPINS);
+    }
+    for (std::size_t i = 0; i < SPINS; ++i) {
+        const Reels reels = engine.rollReels()[0];
+        for (int r = 0; r < REEL_COUNT; ++r) {
+            lanes[r][i] = static_cast<std::uint8_t>(reels[r]);
+        }
+    }
+
+    SpinBatch batch;
+    for (int r = 0; r < REEL_COUNT; ++r) {
+        batch.reels[r] = lanes[r].data();
+    }
+    batch.count = SPINS;
+
+    const BatchEvaluator evaluator(Paytable{}, static_cast<SimdLevel>(level));
+    std::vector<std::int16_t> payouts(SPINS);
+    std::vector<Outcome> outcomes(SPINS);
+    QBENCHMARK {
+        evaluator.evaluate(batch, payouts.data(), outcomes.data());
+    }
+}
+
+void FmchneBench::rollReels() {
+    // Stands in for the old generateRandomSymbol() per reel
+    SpinEngine engine(0x5EED);
+    unsigned sink = 0;
+    QBENCHMARK {
+        const Reels reels = engine.rollReels()[0];
+        sink += static_cast<unsigned>(reels[0]);
+    }
+    QVERIFY(sink != 0xFFFFFFFFu);
+}
+
+void FmchneBench::saveRoundTrip_data() {
+    QTest::addColumn<int>("format");
+    QTest::newRow("Json") << static_cast<int>(SaveFormat::Json);
+    QTest::newRow("Cbor") << static_cast<int>(SaveFormat::Cbor);
+}
+
+void FmchneBench::saveRoundTrip() {
+    QFETCH(int, format);
+
+    SaveData data;
+    data.hasCurrent = true;
+    data.state.money = 12345;
+    data.state.spinCount = 678;
+    data.seed = 0x0123456789ABCDEFull;
+    data.draws = 987654321;
+
+    const QString path = m_workDir.filePath("roundtrip_save");
+    SaveJournal journal(path);
+    journal.setSyncPolicy(SaveJournal::SyncPolicy::OnClose);
+    journal.setSnapshotFormat(static_cast<SaveFormat>(format));
+
+    SaveData loaded;
+    QBENCHMARK {
+        journal.append(data);
+        journal.compact(data);
+        SaveJournal::load(path, loaded);
+    }
+    QVERIFY(loaded == data);
+}
+
+void FmchneBench::screenTransitions() {
+    MainWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    // One menu -> game -> end cycle, each switch painted synchronously. The
+    // menu begins a run in the session log, so the log starts over every
+    // cycle rather than growing for as long as the benchmark runs.
+    QBENCHMARK {
+        window.m_session.start(window.m_engine);
+        window.showScreen(MainWindow::Screen::Start);
+        window.m_screens->repaint();
+        window.showScreen(MainWindow::Screen::Game);
+        window.m_screens->repaint();
+        window.showScreen(MainWindow::Screen::End);
+        window.m_screens->repaint();
+    }
+}
+
+void FmchneBench::rotatedPaint_data() {
+    QTest::addColumn<qreal>("rotation");
+    QTest::addColumn<bool>("shadow");
+    QTest::newRow("0") << qreal(0) << false;
+    QTest::newRow("22.5") << qreal(22.5) << false;
+    QTest::newRow("45") << qreal(45) << false;
+    QTest::newRow("45+shadow") << qreal(45) << true;
+}
+
+void FmchneBench::rotatedPaint() {
+    QFETCH(qreal, rotation);
+    QFETCH(bool, shadow);
+
+    RotatableButton button("Spin");
+    button.setButtonSize(QSize(180, 60));
+    button.setRotation(rotation);
+    button.setShadowVisible(shadow);
+    QImage target(button.size(), QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        target.fill(Qt::transparent);
+        button.render(&target);
+    }
+}
+
+void FmchneBench::hoverPaint_data() {
+    QTest::addColumn<bool>("stylesheetSwap");
+    QTest::newRow("theme") << false;
+    // What every enter and leave used to do before the theme, for comparison
+    QTest::newRow("stylesheet") << true;
+}
+
+void FmchneBench::hoverPaint() {
+    QFETCH(bool, stylesheetSwap);
+
+    // The pre-theme button stylesheets, verbatim
+    const QString defaultSheet =
+        "QPushButton {"
+        "   background-color: qlineargradient(y1: 0, y2: 1, stop: 0 #FFD700, stop: 1 #FF8C00);"
+        "   color: black;"
+        "   border-radius: 10px;"
+        "   font-size: 20px;"
+        "   font-weight: bold;"
+        "   padding: 0px;"
+        "   border: 2px solid #FFD700;"
+        "}"
+        "QPushButton:pressed {"
+        "   background-color: #FF4500;"
+        "   color: white;"
+        "}";
+    const QString hoverSheet =
+        "QPushButton {"
+        "   background-color: #FF6347;"
+        "   border-radius: 10px;"
+        "   font-size: 20px;"
+        "   font-weight: bold;"
+        "   padding: 10px;"
+        "   border: 2px solid #FFD700;"
+        "}";
+
+    RotatableButton button("Spin");
+    button.setButtonSize(QSize(180, 60));
+    if (stylesheetSwap) {
+        button.setStyleSheet(defaultSheet);
+    }
+    QImage target(button.size(), QImage::Format_ARGB32_Premultiplied);
+    const QPointF inside(button.rect().center());
+    QEnterEvent enter(inside, inside, inside);
+    QEvent leave(QEvent::Leave);
+
+    // Enter then leave, each painted synchronously the way the next frame would.
+    // WA_UnderMouse is what QApplication sets around a real enter and leave,
+    // and what puts the hover state into the style option.
+    QBENCHMARK {
+        button.setAttribute(Qt::WA_UnderMouse, true);
+        QCoreApplication::sendEvent(&button, &enter);
+        if (stylesheetSwap) {
+            button.setStyleSheet(hoverSheet);
+        }
+        button.render(&target);
+
+        button.setAttribute(Qt::WA_UnderMouse, false);
+        QCoreApplication::sendEvent(&button, &leave);
+        if (stylesheetSwap) {
+            button.setStyleSheet(defaultSheet);
+        }
+        button.render(&target);
+    }
+}
+
+void FmchneBench::updateMoneyLabel() {
+    MainWindow window;
+    GameState state = window.m_engine.state();
+
+    // Alternate the balance so every call really has to reformat the label
+    int tick = 0;
+    QBENCHMARK {
+        state.money = 100 + (tick++ & 1);
+        window.m_engine.setState(state);
+        window.updateMoneyLabel();
+    }
+}
+
+namespace {
+
+// Per-iteration results from QtTest's XML log, in nanoseconds
+QMap<QString, double> readBenchmarkLog(const QString& path) {
+    QMap<QString, double> results;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return results;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString function;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = xml.attributes().value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            const QXmlStreamAttributes attributes = xml.attributes();
+            const QString tag = attributes.value(QLatin1String("tag")).toString();
+            const QString metric = attributes.value(QLatin1String("metric")).toString();
+            double value = attributes.value(QLatin1String("value")).toDouble();
+            if (metric == QLatin1String("WalltimeMilliseconds")) {
+                value *= 1e6;
+            } else if (metric == QLatin1String("WalltimeNanoseconds")) {
+                // Already nanoseconds
+            } else {
+                continue; // Tick or event counters are not comparable across machines either way
+            }
+            results.insert(tag.isEmpty() ? function : function + ':' + tag, value);
+        }
+    }
+    return results;
+}
+
+QJsonObject toJson(const QMap<QString, double>& results) {
+    QJsonObject object;
+    for (auto it = results.cbegin(); it != results.cend(); ++it) {
+        object[it.key()] = it.value();
+    }
+    return object;
+}
+
+bool writeJson(const QString& path, const QJsonObject& object) {
+    QSaveFile file(path);
+    return file.open(QIODevice::WriteOnly)
+        && file.write(QJsonDocument(object).toJson()) >= 0
+        && file.commit();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    // Same look, and so the same paint cost, as the game
+    Theme::install(app);
+
+    QString baselinePath;
+    QString resultsPath = QStringLiteral("fmchne_bench.json");
+    double margin = qEnvironmentVariableIsSet("FMCHNE_BENCH_MARGIN")
+        ? qEnvironmentVariable("FMCHNE_BENCH_MARGIN").toDouble()
+        : FMCHNE_BENCH_DEFAULT_MARGIN;
+    bool updateBaseline = false;
+
+    // Our own options out, everything else goes to QtTest
+    const QStringList arguments = app.arguments();
+    QStringList testArguments{arguments.first()};
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString& arg = arguments[i];
+        const bool hasValue = i + 1 < arguments.size();
+        if (arg == QLatin1String("--baseline") && hasValue) {
+            baselinePath = arguments[++i];
+        } else if (arg == QLatin1String("--results") && hasValue) {
+            resultsPath = arguments[++i];
+        } else if (arg == QLatin1String("--margin") && hasValue) {
+            margin = arguments[++i].toDouble();
+        } else if (arg == QLatin1String("--update-baseline")) {
+            updateBaseline = true;
+        } else {
+            testArguments << arg;
+        }
+    }
+
+    QTemporaryFile xmlLog;
+    if (!xmlLog.open()) {
+        std::fprintf(stderr, "Could not create the benchmark log\n");
+        return 1;
+    }
+    const QString xmlPath = xmlLog.fileName();
+    xmlLog.close();
+    testArguments << "-o" << xmlPath + ",xml" << "-o" << "-,txt";
+
+    // initTestCase moves into a scratch directory; relative output paths mean this one
+    const QString startDir = QDir::currentPath();
+    FmchneBench bench;
+    const int failures = QTest::qExec(&bench, testArguments);
+    QDir::setCurrent(startDir);
+
+    const QMap<QString, double> results = readBenchmarkLog(xmlPath);
+    if (!writeJson(resultsPath, toJson(results))) {
+        std::fprintf(stderr, "Could not write %s\n", qPrintable(resultsPath));
+    }
+
+    if (baselinePath.isEmpty()) {
+        return failures;
+    }
+    QFile baselineFile(baselinePath);
+    if (updateBaseline) {
+        std::printf("Recording baseline %s\n", qPrintable(baselinePath));
+        return writeJson(baselinePath, toJson(results)) ? failures : 1;
+    }
+    if (!baselineFile.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "Could not read baseline %s; record one with --update-baseline\n",
+                     qPrintable(baselinePath));
+        return failures + 1;
+    }
+
+    const QJsonObject baseline = QJsonDocument::fromJson(baselineFile.readAll()).object();
+    int regressions = 0;
+    for (auto it = results.cbegin(); it != results.cend(); ++it) {
+        if (!baseline.contains(it.key())) {
+            std::printf("%-28s %12.1f ns  no baseline\n", qPrintable(it.key()), it.value());
+            continue;
+        }
+        const double reference = baseline[it.key()].toDouble();
+        const double change = reference > 0 ? it.value() / reference - 1 : 0;
+        const bool regressed = change > margin;
+        std::printf("%-28s %12.1f ns  baseline %12.1f ns  %+6.1f%%%s\n", qPrintable(it.key()),
+                    it.value(), reference, change * 100, regressed ? "  REGRESSION" : "");
+        regressions += regressed ? 1 : 0;
+    }
+    if (regressions > 0) {
+        std::printf("%d benchmark(s) slower than baseline by more than %.0f%%\n", regressions, margin * 100);
+    }
+    return failures + regressions;
+}
+
+#include "fmchne_bench.moc"
@@ -0,0 +1,119 @@
+#include "BalanceChain.h"
+#include "PaytableFile.h"
+
+#include <QtTest>
+#include <cmath>
+
+/*
+ Checks the exact figures fmchne_ruin prints against a direct enumeration
+ of the rules. Every reel combination is played through applyPayout on a
+ balance deep enough that the floor at zero never applies; the per-spin
+ mean and variance of what comes back, and the balance steps the chain is
+ built from, must agree with it.
+*/
+class FmchneChainTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void perSpinMoments_data();
+    void perSpinMoments();
+    void sessionsResolve();
+};
+
+namespace {
+
+constexpr int DEEP_BALANCE = 1'000'000;
+
+struct Moments {
+    double mean{0};
+    double variance{0};
+};
+
+// Amount handed back per spin. A wipe hands back nothing; the rest of the
+// balance it takes is a property of the session, not of the spin.
+Moments enumerateReturns(const Paytable& paytable, const ReelSampler& reels) {
+    const OutcomeTable table = makeOutcomeTable(paytable);
+    double mean = 0;
+    double squares = 0;
+    for (int i = 0; i < OUTCOME_TABLE_SIZE; ++i) {
+        const Reels combination = reelsFromIndex(i);
+        double probability = 1;
+        for (int r = 0; r < REEL_COUNT; ++r) {
+            probability *= reels.probability(r, combination[r]);
+        }
+        const OutcomeEntry& entry = table[i];
+        const int after = applyPayout(DEEP_BALANCE, paytable.cost, entry.payout, entry.wipe);
+        const double returned = entry.wipe ? 0 : after - DEEP_BALANCE + paytable.cost;
+        mean += probability * returned;
+        squares += probability * returned * returned;
+    }
+    return {mean, squares - mean * mean};
+}
+
+} // namespace
+
+Q_DECLARE_METATYPE(Paytable)
+Q_DECLARE_METATYPE(ReelSet)
+
+void FmchneChainTest::perSpinMoments_data() {
+    QTest::addColumn<Paytable>("paytable");
+    QTest::addColumn<ReelSet>("reels");
+
+    Paytable noWipe;
+    noWipe.threeSkullsWipe = false;
+    Paytable custom;
+    custom.cost = 10;
+    custom.jackpot = 1000;
+    custom.threeOfAKind = 0;
+    custom.pair = 15;
+    custom.twoSkullPenalty = 40;
+    ReelSet weighted;
+    weighted.fill(ReelStrip::weighted({5, 1, 4, 4, 2, 3}));
+
+    QTest::newRow("default") << Paytable{} << uniformReels();
+    QTest::newRow("no wipe") << noWipe << uniformReels();
+    QTest::newRow("custom") << custom << uniformReels();
+    QTest::newRow("weighted") << Paytable{} << weighted;
+    QTest::newRow("custom weighted") << custom << weighted;
+}
+
+void FmchneChainTest::perSpinMoments() {
+    QFETCH(Paytable, paytable);
+    QFETCH(ReelSet, reels);
+
+    const ReelSampler sampler(reels);
+    const Moments expected = enumerateReturns(paytable, sampler);
+    const PaytableReport report = compilePaytable(paytable, sampler).report;
+    QCOMPARE(report.rtp * paytable.cost, expected.mean);
+    QCOMPARE(report.variance, expected.variance);
+
+    // The steps the chain moves the balance by, with a wipe costing the stake
+    Moments steps;
+    double total = 0;
+    double squares = 0;
+    for (const BalanceStep& step : balanceSteps(paytable, makeOutcomeTable(paytable), sampler)) {
+        const double returned = step.wipe ? 0 : step.delta + paytable.cost;
+        total += step.probability;
+        steps.mean += step.probability * returned;
+        squares += step.probability * returned * returned;
+    }
+    steps.variance = squares - steps.mean * steps.mean;
+    QCOMPARE(total, 1.0);
+    QCOMPARE(steps.mean, expected.mean);
+    QCOMPARE(steps.variance, expected.variance);
+}
+
+void FmchneChainTest::sessionsResolve() {
+    // Every session ends broke, wiped or at the target, bar the reported remainder
+    BalanceChainConfig config;
+    config.target = 500;
+    config.threads = 1;
+    const BalanceChainResult result = analyseSessions(config);
+    QVERIFY(result.unresolved < 1e-9);
+    const double ended = result.bustProbability() + result.targetProbability + result.unresolved;
+    QVERIFY2(std::abs(ended - 1) < 1e-9, qPrintable(QString("Sessions sum to %1").arg(ended, 0, 'g', 15)));
+    QVERIFY(result.expectedSpins > 0);
+}
+
+QTEST_APPLESS_MAIN(FmchneChainTest)
+#include "fmchne_chain_test.moc"
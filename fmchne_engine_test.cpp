@@ -0,0 +1,290 @@
+#include "MonteCarlo.h"
+#include "PaytableFile.h"
+#include "SpinEngine.h"
+
+#include <QtTest>
+#include <cmath>
+#include <random>
+
+/*
+ Checks the templated engine against what it replaced and against the
+ layouts it now supports: the classic 3x1 machine must draw exactly the
+ stream the pre-template engine drew for the same seed, and the 5x3
+ twenty-line machine must read its window off the strips and score every
+ payline into the right bit. The exact paytable figures are checked against
+ the rules by hand and against a seeded simulation, and restoring a save's
+ RNG position has to land exactly where stepping the generator would.
+*/
+class FmchneEngineTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void classicStream_data();
+    void classicStream();
+    void fiveByThreeWindow();
+    void fiveByThreeLines_data();
+    void fiveByThreeLines();
+    void restoreDraws_data();
+    void restoreDraws();
+    void defaultPaytableReport();
+    void paytableReportMatchesSimulation();
+};
+
+namespace {
+
+using FiveByThreeWindow = FiveByThreeEngine::Window;
+
+GameState richState() {
+    GameState state;
+    state.money = 1'000'000;
+    return state;
+}
+
+// Strips that always stop on their first stop, so the spin shows exactly this window
+FiveByThreeEngine::ReelSetType fixedWindow(const FiveByThreeWindow& window) {
+    FiveByThreeEngine::ReelSetType reels;
+    for (int r = 0; r < FiveByThreeEngine::REELS; ++r) {
+        for (int row = 0; row < FiveByThreeEngine::ROWS; ++row) {
+            reels[r].stops.push_back(window[row][r]);
+            reels[r].weights.push_back(row == 0 ? 1 : 0);
+        }
+    }
+    return reels;
+}
+
+std::uint64_t fnv1a(std::uint64_t hash, std::uint64_t value) {
+    return (hash ^ value) * 1099511628211ull;
+}
+
+} // namespace
+
+Q_DECLARE_METATYPE(FiveByThreeWindow)
+
+void FmchneEngineTest::classicStream_data() {
+    QTest::addColumn<bool>("weighted");
+    QTest::addColumn<quint64>("hash");
+    QTest::addColumn<int>("money");
+    QTest::addColumn<quint64>("draws");
+
+    // Recorded from the pre-template SpinEngine (d8c8c89) with the same loop
+    QTest::newRow("uniform") << false << quint64(0x2a637fd392521290ull) << 999540 << quint64(100000);
+    QTest::newRow("weighted") << true << quint64(0xe942c5ae02031694ull) << 997840 << quint64(300000);
+}
+
+void FmchneEngineTest::classicStream() {
+    QFETCH(bool, weighted);
+    QFETCH(quint64, hash);
+    QFETCH(int, money);
+    QFETCH(quint64, draws);
+
+    SpinEngine engine(0x5EED);
+    if (weighted) {
+        ReelSet reels;
+        reels.fill(ReelStrip::weighted({5, 1, 4, 4, 2, 3}));
+        QVERIFY(engine.setReelStrips(reels));
+    }
+    engine.setState(richState());
+
+    // Every combination and balance change, in order
+    std::uint64_t stream = 1469598103934665603ull;
+    for (int i = 0; i < 100'000; ++i) {
+        const SpinResult result = engine.spin();
+        const Reels& line = result.window[0];
+        stream = fnv1a(stream, static_cast<std::uint64_t>(lineIndex<REEL_COUNT>(line)));
+        stream = fnv1a(stream, static_cast<std::uint64_t>(static_cast<std::int64_t>(result.delta)));
+        if (!engine.canSpin()) {
+            engine.setState(richState());
+        }
+    }
+    QCOMPARE(quint64(stream), hash);
+    QCOMPARE(engine.state().money, money);
+    QCOMPARE(quint64(engine.draws()), draws);
+}
+
+void FmchneEngineTest::fiveByThreeWindow() {
+    // Strips of different lengths and weights, so rows wrap around at different stops
+    std::mt19937 gen(0x5EED);
+    std::uniform_int_distribution<int> symbol(0, SYMBOL_COUNT - 1);
+    std::uniform_int_distribution<std::uint32_t> weight(1, 9);
+    FiveByThreeEngine::ReelSetType reels;
+    const int lengths[FiveByThreeEngine::REELS] = {7, 5, 9, 6, 11};
+    for (int r = 0; r < FiveByThreeEngine::REELS; ++r) {
+        for (int stop = 0; stop < lengths[r]; ++stop) {
+            reels[r].stops.push_back(static_cast<Symbol>(symbol(gen)));
+            reels[r].weights.push_back(weight(gen));
+        }
+    }
+
+    FiveByThreeEngine engine(0x5EED);
+    QVERIFY(engine.setReelStrips(reels));
+    engine.setState(richState());
+    for (int i = 0; i < 10'000; ++i) {
+        const FiveByThreeEngine::Result result = engine.spin();
+        for (int r = 0; r < FiveByThreeEngine::REELS; ++r) {
+            const std::vector<Symbol>& stops = reels[r].stops;
+            QVERIFY(result.stops[r] < stops.size());
+            for (int row = 0; row < FiveByThreeEngine::ROWS; ++row) {
+                QCOMPARE(static_cast<int>(result.window[row][r]), static_cast<int>(stops[(result.stops[r] + row) % stops.size()]));
+            }
+        }
+
+        // Each bit is its payline read off the window
+        std::uint32_t expected = 0;
+        Outcome worst = Outcome::Loss;
+        for (int line = 0; line < FiveByThreeEngine::LINES; ++line) {
+            LineSymbols<5> symbols;
+            for (int r = 0; r < FiveByThreeEngine::REELS; ++r) {
+                symbols[r] = result.window[TwentyLines::ROWS[line][r]][r];
+            }
+            const Outcome outcome = classifyLine<5>(symbols);
+            expected |= isWin(outcome) ? std::uint32_t{1} << line : 0;
+            worst = std::max(worst, outcome);
+        }
+        QCOMPARE(result.winningLines, expected);
+        QCOMPARE(static_cast<int>(result.outcome), static_cast<int>(worst));
+        if (!engine.canSpin()) {
+            engine.setState(richState());
+        }
+    }
+}
+
+void FmchneEngineTest::fiveByThreeLines_data() {
+    QTest::addColumn<FiveByThreeWindow>("window");
+    QTest::addColumn<quint32>("winningLines");
+    QTest::addColumn<int>("outcome");
+    QTest::addColumn<int>("delta");
+
+    using S = Symbol;
+    const LineSymbols<5> distinct{S::Cherry, S::Bell, S::Lemon, S::Orange, S::Star};
+    LineSymbols<5> bells;
+    bells.fill(S::Bell);
+    LineSymbols<5> skulls;
+    skulls.fill(S::Skull);
+
+    // Every line reads Cherry, Bell, Lemon, Orange, Star: twenty losses at 20p each
+    QTest::newRow("nothing") << FiveByThreeWindow{distinct, distinct, distinct}
+                             << quint32(0) << static_cast<int>(Outcome::Loss) << -400;
+    // The middle line is the jackpot; any other line that crosses the middle
+    // row on a reel other than the second pairs with the second reel's Bell,
+    // which leaves lines 1, 2, 17, 18 and 19 losing. 500 + 14 * 50 - 400
+    QTest::newRow("middle bells") << FiveByThreeWindow{distinct, bells, distinct}
+                                  << quint32(0xFFFFF & ~((1u << 1) | (1u << 2) | (1u << 17) | (1u << 18) | (1u << 19)))
+                                  << static_cast<int>(Outcome::Jackpot) << 800;
+    // The top line holds five skulls and wipes the balance; nothing else pays
+    QTest::newRow("top skulls") << FiveByThreeWindow{skulls, distinct, distinct}
+                                << quint32(0) << static_cast<int>(Outcome::ThreeSkulls) << -1'000'000;
+}
+
+void FmchneEngineTest::fiveByThreeLines() {
+    QFETCH(FiveByThreeWindow, window);
+    QFETCH(quint32, winningLines);
+    QFETCH(int, outcome);
+    QFETCH(int, delta);
+
+    FiveByThreeEngine engine(0x5EED);
+    QVERIFY(engine.setReelStrips(fixedWindow(window)));
+    engine.setState(richState());
+    const FiveByThreeEngine::Result result = engine.spin();
+    QVERIFY(result.window == window);
+    QCOMPARE(result.winningLines, winningLines);
+    QCOMPARE(static_cast<int>(result.outcome), outcome);
+    QCOMPARE(result.delta, delta);
+}
+
+void FmchneEngineTest::restoreDraws_data() {
+    QTest::addColumn<quint64>("draws");
+    // Either side of where discard() stops stepping and jumps instead
+    for (quint64 draws : {quint64(0), quint64(1), quint64(131'071), quint64(131'072), quint64(131'073), quint64(3'000'017)}) {
+        QTest::addRow("%llu", static_cast<unsigned long long>(draws)) << draws;
+    }
+}
+
+void FmchneEngineTest::restoreDraws() {
+    QFETCH(quint64, draws);
+
+    SpinRng stepped(0x5EED);
+    for (quint64 i = 0; i < draws; ++i) {
+        stepped();
+    }
+    SpinRng jumped(0x5EED);
+    jumped.discard(draws);
+    QVERIFY(jumped == stepped);
+
+    // Far past anything stepping could check, split jumps must agree
+    SpinRng whole(0x5EED);
+    whole.discard(draws + 0xFFFF'FFFF'FFFFull);
+    jumped.discard(0xFFFF'FFFF'FFFFull);
+    QVERIFY(jumped == whole);
+
+    // A restored engine carries on with exactly the spins the original would have
+    SpinEngine original(0x5EED);
+    original.setState(richState());
+    while (original.draws() < draws) {
+        original.spin();
+        if (!original.canSpin()) {
+            original.setState(richState());
+        }
+    }
+    SpinEngine restored(1);
+    restored.reseed(original.seed(), original.draws());
+    restored.setState(original.state());
+    for (int i = 0; i < 1000; ++i) {
+        const SpinResult expected = original.spin();
+        const SpinResult result = restored.spin();
+        QVERIFY(result.window == expected.window);
+        QCOMPARE(result.delta, expected.delta);
+        if (!original.canSpin()) {
+            original.setState(richState());
+            restored.setState(richState());
+        }
+    }
+    QCOMPARE(restored.draws(), original.draws());
+}
+
+void FmchneEngineTest::defaultPaytableReport() {
+    // Of the 216 equally likely spins: one jackpot, four other three of a
+    // kinds, 60 skull-free pairs, and 15 two-skull penalties
+    const PaytableReport report = compilePaytable(Paytable{}).report;
+    QCOMPARE(report.rtp, 120.0 / 216.0);
+    QCOMPARE(report.hitFrequency, 65.0 / 216.0);
+    const double mean = 2400.0 / 216.0;
+    QCOMPARE(report.variance, 590'000.0 / 216.0 - mean * mean);
+}
+
+void FmchneEngineTest::paytableReportMatchesSimulation() {
+    SimulationConfig config;
+    config.spins = 4'000'000;
+    config.chunkSpins = 1 << 18;
+    config.startingMoney = 1'000'000'000; // Too deep for the floor at zero to ever matter
+
+    // A wipe takes the whole balance in play, which the report leaves out,
+    // so the default table is checked through how often each outcome came up
+    {
+        const PaytableReport report = compilePaytable(config.paytable).report;
+        const SimulationStats stats = runSimulation(config);
+        QCOMPARE(stats.spins, config.spins);
+        double paid = 0;
+        for (int i = 0; i < OUTCOME_COUNT; ++i) {
+            paid += static_cast<double>(stats.outcomes[i]) * payoutFor(static_cast<Outcome>(i), config.paytable);
+        }
+        const double rtp = paid / static_cast<double>(stats.wagered);
+        const double standardError = std::sqrt(report.variance / config.spins) / config.paytable.cost;
+        QVERIFY2(std::abs(rtp - report.rtp) < 5 * standardError,
+                 qPrintable(QString("Simulated %1, exact %2").arg(rtp).arg(report.rtp)));
+    }
+
+    // Without the wipe every spin hands back exactly its payout
+    config.paytable.threeSkullsWipe = false;
+    {
+        const PaytableReport report = compilePaytable(config.paytable).report;
+        const SimulationStats stats = runSimulation(config);
+        const double standardError = std::sqrt(report.variance / config.spins) / config.paytable.cost;
+        QVERIFY2(std::abs(stats.rtp() - report.rtp) < 5 * standardError,
+                 qPrintable(QString("Simulated %1, exact %2").arg(stats.rtp()).arg(report.rtp)));
+        QVERIFY2(std::abs(stats.variance() / report.variance - 1) < 0.02,
+                 qPrintable(QString("Simulated %1, exact %2").arg(stats.variance()).arg(report.variance)));
+    }
+}
+
+QTEST_APPLESS_MAIN(FmchneEngineTest)
+#include "fmchne_engine_test.moc"
@@ -0,0 +1,142 @@
+#include "SaveJournal.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+/*
+ Checks how the save journal recovers from a crash: loading replays every
+ intact record and stops at the first torn or corrupt one, and reopening
+ the journal cuts that tail off so the next record follows the last good
+ one. The crash is simulated by copying the journal while its writer is
+ still open, before close() would fold it into a snapshot.
+*/
+class FmchneJournalTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void replaysEveryRecord();
+    void damagedRecord_data();
+    void damagedRecord();
+    void reopenDropsTornTail();
+
+private:
+    // A journal of RECORDS records, left as a crash would leave it; returns its snapshot path
+    QString crashedJournal(const QString& name);
+
+    QTemporaryDir m_workDir;
+};
+
+namespace {
+
+constexpr int RECORDS = 10;
+constexpr int RECORD_SIZE = 60; // Length, CRC and the 52-byte payload
+
+SaveData record(int index) {
+    SaveData data;
+    data.hasCurrent = true;
+    data.state.money = 1000 + index;
+    data.state.spinCount = index;
+    data.state.totalSpins = 100 + index;
+    data.seed = 0x0123456789ABCDEFull;
+    data.draws = static_cast<std::uint64_t>(index) * 3;
+    return data;
+}
+
+QByteArray readAll(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+bool writeAll(const QString& path, const QByteArray& bytes) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(bytes) == bytes.size();
+}
+
+} // namespace
+
+void FmchneJournalTest::initTestCase() {
+    QVERIFY(m_workDir.isValid());
+}
+
+QString FmchneJournalTest::crashedJournal(const QString& name) {
+    const QString live = m_workDir.filePath(name + "_live.json");
+    const QString crashed = m_workDir.filePath(name + ".json");
+
+    SaveJournal journal(live);
+    journal.setSyncPolicy(SaveJournal::SyncPolicy::EveryRecord);
+    for (int i = 0; i < RECORDS; ++i) {
+        journal.append(record(i));
+    }
+    // Every record is on disk now; closing would compact it away
+    QFile::remove(SaveJournal::journalPath(crashed));
+    QFile::copy(SaveJournal::journalPath(live), SaveJournal::journalPath(crashed));
+    return crashed;
+}
+
+void FmchneJournalTest::replaysEveryRecord() {
+    const QString path = crashedJournal("intact");
+    QCOMPARE(readAll(SaveJournal::journalPath(path)).size(), qsizetype(RECORDS * RECORD_SIZE));
+
+    SaveData loaded;
+    QVERIFY(SaveJournal::load(path, loaded));
+    QVERIFY(loaded == record(RECORDS - 1));
+}
+
+void FmchneJournalTest::damagedRecord_data() {
+    QTest::addColumn<int>("offset");     // Byte changed, or the new length when truncating
+    QTest::addColumn<bool>("truncate");
+    QTest::addColumn<int>("lastIntact"); // Record the load should end on
+
+    const int last = (RECORDS - 1) * RECORD_SIZE;
+    QTest::newRow("torn last record") << last + 7 << true << RECORDS - 2;
+    QTest::newRow("torn header") << last + 3 << true << RECORDS - 2;
+    QTest::newRow("bad length") << last << false << RECORDS - 2;
+    QTest::newRow("bad crc") << last + 4 << false << RECORDS - 2;
+    QTest::newRow("bad payload") << last + RECORD_SIZE - 1 << false << RECORDS - 2;
+    // Replay stops at the first bad record, whatever follows it
+    QTest::newRow("bad middle record") << 4 * RECORD_SIZE + 20 << false << 3;
+}
+
+void FmchneJournalTest::damagedRecord() {
+    QFETCH(int, offset);
+    QFETCH(bool, truncate);
+    QFETCH(int, lastIntact);
+
+    const QString path = crashedJournal(QString("damaged_%1_%2").arg(offset).arg(truncate));
+    const QString journalPath = SaveJournal::journalPath(path);
+    QByteArray bytes = readAll(journalPath);
+    if (truncate) {
+        bytes.truncate(offset);
+    } else {
+        bytes[offset] = static_cast<char>(bytes[offset] ^ 0x10);
+    }
+    QVERIFY(writeAll(journalPath, bytes));
+
+    SaveData loaded;
+    QVERIFY(SaveJournal::load(path, loaded));
+    QVERIFY(loaded == record(lastIntact));
+}
+
+void FmchneJournalTest::reopenDropsTornTail() {
+    const QString path = crashedJournal("reopened");
+    const QString journalPath = SaveJournal::journalPath(path);
+    QByteArray bytes = readAll(journalPath);
+    bytes.truncate((RECORDS - 1) * RECORD_SIZE + 25);
+    QVERIFY(writeAll(journalPath, bytes));
+
+    SaveJournal journal(path);
+    journal.setSyncPolicy(SaveJournal::SyncPolicy::EveryRecord);
+    QVERIFY(journal.append(record(RECORDS)));
+
+    // The new record sits straight after the last intact one
+    QCOMPARE(readAll(journalPath).size(), qsizetype(RECORDS * RECORD_SIZE));
+    SaveData loaded;
+    QVERIFY(SaveJournal::load(path, loaded));
+    QVERIFY(loaded == record(RECORDS));
+}
+
+QTEST_APPLESS_MAIN(FmchneJournalTest)
+#include "fmchne_journal_test.moc"
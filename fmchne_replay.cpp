@@ -0,0 +1,54 @@
+#include "SessionLog.h"
+
+#include <QString>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::printf(
+        "Usage: %s SESSION\n"
+        "  Replays a session FMCHNE recorded (game_session-<time>-<seed>.json beside\n"
+        "  the save, one per launch, or the file given to --record) on a fresh\n"
+        "  engine and checks balances, max money, highest spin and all-time stats\n"
+        "  after every action. Exits non-zero on the first divergence.\n",
+        program);
+}
+
+void printState(const char* label, const GameState& state, std::uint64_t draws) {
+    std::printf("  %-9s money=%d spins=%d maxMoney=%d highestSpin=%d totalSpins=%d "
+                "totalMoneyEarnt=%d allTimeHighestMoney=%d runs=%d draws=%llu\n",
+                label, state.money, state.spinCount, state.maxMoney, state.highestSpin,
+                state.totalSpins, state.totalMoneyEarnt, state.allTimeHighestMoney,
+                state.runsPlayed, static_cast<unsigned long long>(draws));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2 || std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0) {
+        printUsage(argv[0]);
+        return argc == 2 ? 0 : 1;
+    }
+
+    SessionLog log;
+    if (!readSession(QString::fromLocal8Bit(argv[1]), log)) {
+        std::fprintf(stderr, "Could not read session %s\n", argv[1]);
+        return 1;
+    }
+
+    const ReplayResult result = replaySession(log);
+    if (!result.matched) {
+        std::printf("MISMATCH at event %zu of %zu\n", result.eventIndex, log.events.size());
+        printState("expected", result.expected, result.expectedDraws);
+        printState("actual", result.actual, result.actualDraws);
+        return 1;
+    }
+
+    std::printf("OK: %zu events, %llu spins replayed bit for bit\n", log.events.size(),
+                static_cast<unsigned long long>(result.spins));
+    printState("final", result.actual, result.actualDraws);
+    return 0;
+}
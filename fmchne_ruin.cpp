@@ -0,0 +1,143 @@
+#include "BalanceChain.h"
+#include "PaytableFile.h"
+
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::printf(
+        "Usage: %s [options]\n"
+        "  --balance N    Starting balance in pence (default 100)\n"
+        "  --target N     Walk away on reaching this balance, 0 to play until bust (default 0)\n"
+        "  --bins N       maxMoney histogram bins (default 32)\n"
+        "  --bin-width N  Width of each bin in pence, 0 to choose one (default 0)\n"
+        "  --tolerance X  Stop once this much probability is still in play (default 1e-12)\n"
+        "  --max-spins N  Stop after this many spins regardless (default 100000000)\n"
+        "  --threads N    Worker threads, 0 for all cores (default 0)\n"
+        "  --weights W    Six comma separated symbol weights applied to every reel,\n"
+        "                 in the order Cherry,Bell,Lemon,Orange,Star,Skull\n"
+        "  --paytable F   Load the paytable from a JSON file\n",
+        program);
+}
+
+bool parseWeights(const char* text, std::array<std::uint32_t, SYMBOL_COUNT>& weights) {
+    const char* cursor = text;
+    for (int i = 0; i < SYMBOL_COUNT; ++i) {
+        char* end = nullptr;
+        weights[i] = static_cast<std::uint32_t>(std::strtoul(cursor, &end, 10));
+        if (end == cursor || (i + 1 < SYMBOL_COUNT && *end != ',')) {
+            return false;
+        }
+        cursor = end + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+// Answers balance questions (how long a session lasts, how likely it is to
+// go bust, how high the balance gets) exactly, instead of simulating them
+int main(int argc, char *argv[])
+{
+    BalanceChainConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (std::strcmp(arg, "--balance") == 0 && hasValue) {
+            config.startingMoney = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--target") == 0 && hasValue) {
+            config.target = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--bins") == 0 && hasValue) {
+            config.bins = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--bin-width") == 0 && hasValue) {
+            config.binWidth = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--tolerance") == 0 && hasValue) {
+            config.tolerance = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(arg, "--max-spins") == 0 && hasValue) {
+            config.maxSpins = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            config.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--weights") == 0 && hasValue) {
+            std::array<std::uint32_t, SYMBOL_COUNT> weights;
+            std::string error;
+            if (!parseWeights(argv[++i], weights)) {
+                std::fprintf(stderr, "Expected six comma separated weights\n");
+                return 1;
+            }
+            config.reels.fill(ReelStrip::weighted(weights));
+            if (!validateReels(config.reels, &error)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--paytable") == 0 && hasValue) {
+            CompiledPaytable compiled;
+            QString error;
+            if (!loadPaytable(QString::fromLocal8Bit(argv[++i]), compiled, &error)) {
+                std::fprintf(stderr, "%s\n", qPrintable(error));
+                return 1;
+            }
+            config.paytable = compiled.paytable;
+        } else {
+            std::fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.startingMoney < 0 || config.target < 0) {
+        std::fprintf(stderr, "Balances must not be negative\n");
+        return 1;
+    }
+
+    const ReelSampler reels(config.reels);
+    const PaytableReport report = compilePaytable(config.paytable, reels).report;
+    std::printf("Per spin:       RTP %.6f%%, hit frequency %.6f%%, variance %.3f pence^2 (sd %.3f)\n",
+                report.rtp * 100, report.hitFrequency * 100, report.variance, std::sqrt(report.variance));
+    std::printf("Balance steps: ");
+    for (const BalanceStep& step : balanceSteps(config.paytable, makeOutcomeTable(config.paytable), reels)) {
+        if (step.wipe) {
+            std::printf("  wipe %.6f", step.probability);
+        } else {
+            std::printf("  %+d %.6f", step.delta, step.probability);
+        }
+    }
+    std::printf("\n");
+
+    const BalanceChainResult result = analyseSessions(config);
+
+    std::printf("Sessions from:  %d pence", config.startingMoney);
+    if (config.target > 0) {
+        std::printf(", walking away at %d", config.target);
+    }
+    std::printf("\n");
+    std::printf("Time:           %.3f s (%llu spins over up to %zu states %dp apart)\n",
+                result.seconds, static_cast<unsigned long long>(result.spins),
+                result.peakStates, result.stateSpacing);
+    std::printf("Session length: %.6f spins expected, median %llu\n",
+                result.expectedSpins, static_cast<unsigned long long>(result.medianSpins));
+    std::printf("Bust:           %.9f (%.9f below the stake, %.9f wiped)\n",
+                result.bustProbability(), result.brokeProbability, result.wipeProbability);
+    if (config.target > 0) {
+        std::printf("Target:         %.9f\n", result.targetProbability);
+    }
+    std::printf("Unresolved:     %.3g\n", result.unresolved);
+    std::printf("Highest balance reached:\n");
+    for (const MaxMoneyBin& bin : result.maxMoney) {
+        if (bin.to == INT_MAX) {
+            std::printf("  %10d+           %.9f\n", bin.from, bin.probability);
+        } else {
+            std::printf("  %10d .. %-10d %.9f\n", bin.from, bin.to - 1, bin.probability);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "MonteCarlo.h"
+#include "PaytableFile.h"
+#include "SpinEngine.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::printf(
+        "Usage: %s [options]\n"
+        "  --spins N      Total spins to simulate (default 1000000000)\n"
+        "  --threads N    Worker threads, 0 for all cores (default 0)\n"
+        "  --chunk N      Spins per scheduled chunk (default 1048576)\n"
+        "  --seed N       Base seed for the per-chunk RNG streams\n"
+        "  --balance N    Starting balance of each session in pence (default 100)\n"
+        "  --weights W    Six comma separated symbol weights applied to every reel,\n"
+        "                 in the order Cherry,Bell,Lemon,Orange,Star,Skull\n"
+        "  --paytable F   Load the paytable from a JSON file\n"
+        "  --rng-bench N  Time N reel rolls with the old and current generators and exit\n",
+        program);
+}
+
+template <typename Roll>
+double nanosecondsPerSpin(std::uint64_t spins, Roll roll) {
+    unsigned sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < spins; ++i) {
+        sink += roll();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Keep the loop from being optimised away
+    if (sink == 0xFFFFFFFFu) {
+        std::printf(" ");
+    }
+    return seconds * 1e9 / static_cast<double>(spins);
+}
+
+void benchmarkRng(std::uint64_t spins) {
+    // What generateRandomSymbol() used to do: shared mt19937 and a fresh distribution per call
+    std::mt19937 legacy(std::random_device{}());
+    const double legacyNs = nanosecondsPerSpin(spins, [&legacy]() {
+        std::uniform_int_distribution<> dis(0, SYMBOL_COUNT - 1);
+        unsigned sum = 0;
+        for (int i = 0; i < REEL_COUNT; ++i) {
+            sum += static_cast<unsigned>(dis(legacy));
+        }
+        return sum;
+    });
+
+    SpinEngine engine(0x5EED);
+    const double currentNs = nanosecondsPerSpin(spins, [&engine]() {
+        const Reels reels = engine.rollReels()[0];
+        return static_cast<unsigned>(reels[0]) + static_cast<unsigned>(reels[1]) + static_cast<unsigned>(reels[2]);
+    });
+
+    std::printf("mt19937 + uniform_int_distribution: %.2f ns/spin\n", legacyNs);
+    std::printf("xoshiro256** + Lemire:              %.2f ns/spin\n", currentNs);
+}
+
+bool parseWeights(const char* text, std::array<std::uint32_t, SYMBOL_COUNT>& weights) {
+    const char* cursor = text;
+    for (int i = 0; i < SYMBOL_COUNT; ++i) {
+        char* end = nullptr;
+        weights[i] = static_cast<std::uint32_t>(std::strtoul(cursor, &end, 10));
+        if (end == cursor || (i + 1 < SYMBOL_COUNT && *end != ',')) {
+            return false;
+        }
+        cursor = end + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    SimulationConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (std::strcmp(arg, "--spins") == 0 && hasValue) {
+            config.spins = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            config.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--chunk") == 0 && hasValue) {
+            config.chunkSpins = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(arg, "--balance") == 0 && hasValue) {
+            config.startingMoney = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--weights") == 0 && hasValue) {
+            std::array<std::uint32_t, SYMBOL_COUNT> weights;
+            std::string error;
+            if (!parseWeights(argv[++i], weights)) {
+                std::fprintf(stderr, "Expected six comma separated weights\n");
+                return 1;
+            }
+            config.reels.fill(ReelStrip::weighted(weights));
+            if (!validateReels(config.reels, &error)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--paytable") == 0 && hasValue) {
+            CompiledPaytable compiled;
+            QString error;
+            if (!loadPaytable(QString::fromLocal8Bit(argv[++i]), compiled, &error)) {
+                std::fprintf(stderr, "%s\n", qPrintable(error));
+                return 1;
+            }
+            config.paytable = compiled.paytable;
+        } else if (std::strcmp(arg, "--rng-bench") == 0 && hasValue) {
+            benchmarkRng(std::strtoull(argv[++i], nullptr, 10));
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.startingMoney < config.paytable.cost) {
+        std::fprintf(stderr, "The starting balance (%d) must cover the stake (%d)\n",
+                     config.startingMoney, config.paytable.cost);
+        return 1;
+    }
+
+    const SimulationStats stats = runSimulation(config);
+
+    static const char* outcomeNames[OUTCOME_COUNT] = {
+        "Loss", "Pair", "Three of a kind", "Jackpot", "Two skulls", "Three skulls"
+    };
+
+    const double rtp = stats.rtp();
+    const double halfWidth = stats.confidenceHalfWidth();
+    std::printf("Spins:          %llu in %llu sessions\n",
+                static_cast<unsigned long long>(stats.spins),
+                static_cast<unsigned long long>(stats.sessions));
+    std::printf("Time:           %.3f s (%.1f M spins/s)\n",
+                stats.seconds, stats.seconds > 0 ? stats.spins / stats.seconds / 1e6 : 0.0);
+    std::printf("RTP:            %.6f%% (95%% CI %.6f%% .. %.6f%%)\n",
+                rtp * 100, (rtp - halfWidth) * 100, (rtp + halfWidth) * 100);
+    // The exact figure leaves out the balance floor and wipes, which the simulation plays out
+    const PaytableReport exact = compilePaytable(config.paytable, ReelSampler(config.reels)).report;
+    std::printf("Exact RTP:      %.6f%% per spin, before the balance floor and wipes\n", exact.rtp * 100);
+    std::printf("Hit frequency:  %.6f%%\n", stats.hitFrequency() * 100);
+    std::printf("Variance:       %.3f pence^2 per spin (sd %.3f)\n",
+                stats.variance(), std::sqrt(stats.variance()));
+    for (int i = 0; i < OUTCOME_COUNT; ++i) {
+        std::printf("  %-16s %.6f%%\n", outcomeNames[i],
+                    stats.spins ? 100.0 * stats.outcomes[i] / stats.spins : 0.0);
+    }
+    return 0;
+}
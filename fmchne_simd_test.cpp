@@ -0,0 +1,126 @@
+#include "BatchEvaluator.h"
+
+#include <QtTest>
+#include <random>
+#include <vector>
+
+/*
+ Checks every vector path of the BatchEvaluator against the scalar one,
+ spin for spin. Counts that are not a multiple of any vector width make
+ sure the scalar tail picks up exactly where the vector loop stopped.
+ Levels the CPU running the test does not support are skipped.
+*/
+class FmchneSimdTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void evaluate_data();
+    void evaluate();
+    void scoreSession_data();
+    void scoreSession();
+};
+
+namespace {
+
+// One lane of uniformly random symbols per reel
+struct Lanes {
+    std::vector<std::uint8_t> reels[REEL_COUNT];
+
+    Lanes(std::size_t count, std::uint32_t seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> symbol(0, SYMBOL_COUNT - 1);
+        for (auto& lane : reels) {
+            lane.resize(count);
+            for (auto& value : lane) {
+                value = static_cast<std::uint8_t>(symbol(gen));
+            }
+        }
+    }
+
+    SpinBatch batch() const {
+        SpinBatch batch;
+        for (int r = 0; r < REEL_COUNT; ++r) {
+            batch.reels[r] = reels[r].data();
+        }
+        batch.count = reels[0].size();
+        return batch;
+    }
+};
+
+void addLevelRows(const QList<std::size_t>& counts) {
+    QTest::addColumn<int>("level");
+    QTest::addColumn<qulonglong>("count");
+    for (SimdLevel level : {SimdLevel::Sse42, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        for (std::size_t count : counts) {
+            QTest::addRow("%s/%zu", simdLevelName(level), count) << static_cast<int>(level) << qulonglong(count);
+        }
+    }
+}
+
+void skipUnsupported(SimdLevel level) {
+    if (detectSimdLevel() < level) {
+        QSKIP(qPrintable(QString("%1 is not supported on this CPU").arg(simdLevelName(level))));
+    }
+}
+
+} // namespace
+
+void FmchneSimdTest::evaluate_data() {
+    addLevelRows({1, 15, 17, 31, 33, 63, 65, 1000, 4097, 1'000'003});
+}
+
+void FmchneSimdTest::evaluate() {
+    QFETCH(int, level);
+    QFETCH(qulonglong, count);
+    skipUnsupported(static_cast<SimdLevel>(level));
+
+    const Lanes lanes(count, 0x5EED + static_cast<std::uint32_t>(count));
+    const SpinBatch batch = lanes.batch();
+    const BatchEvaluator vector(Paytable{}, static_cast<SimdLevel>(level));
+    const BatchEvaluator scalar(Paytable{}, SimdLevel::Scalar);
+    QCOMPARE(vector.level(), static_cast<SimdLevel>(level));
+
+    std::vector<std::int16_t> payouts(count), expectedPayouts(count);
+    std::vector<Outcome> outcomes(count), expectedOutcomes(count);
+    vector.evaluate(batch, payouts.data(), outcomes.data());
+    scalar.evaluate(batch, expectedPayouts.data(), expectedOutcomes.data());
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (payouts[i] != expectedPayouts[i] || outcomes[i] != expectedOutcomes[i]) {
+            QFAIL(qPrintable(QString("Spin %1 differs from the scalar path").arg(i)));
+        }
+    }
+}
+
+void FmchneSimdTest::scoreSession_data() {
+    addLevelRows({17, 4095, 4097, 250'001});
+}
+
+void FmchneSimdTest::scoreSession() {
+    QFETCH(int, level);
+    QFETCH(qulonglong, count);
+    skipUnsupported(static_cast<SimdLevel>(level));
+
+    const Lanes lanes(count, 0xC0FFEE + static_cast<std::uint32_t>(count));
+    const SpinBatch batch = lanes.batch();
+
+    // A wipe ends most sessions early; without one the balance runs the whole batch
+    Paytable noWipe;
+    noWipe.threeSkullsWipe = false;
+    for (const Paytable& paytable : {Paytable{}, noWipe}) {
+        const BatchEvaluator vector(paytable, static_cast<SimdLevel>(level));
+        const BatchEvaluator scalar(paytable, SimdLevel::Scalar);
+        for (int startingMoney : {100, 10'000'000}) {
+            const SessionScore score = vector.scoreSession(batch, startingMoney);
+            const SessionScore expected = scalar.scoreSession(batch, startingMoney);
+            QCOMPARE(score.spinsPlayed, expected.spinsPlayed);
+            QCOMPARE(score.finalMoney, expected.finalMoney);
+            QCOMPARE(score.maxMoney, expected.maxMoney);
+            QCOMPARE(score.moneyEarnt, expected.moneyEarnt);
+            QCOMPARE(score.bust, expected.bust);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(FmchneSimdTest)
+#include "fmchne_simd_test.moc"
@@ -1,11 +1,48 @@
 #include "mainwindow.h"
+#include "Logging.h"
+#include "PerfMonitor.h"
+#include "Theme.h"
 
-#include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    // Outlives the application so shutdown messages are still flushed
+    AsyncLogSink logSink;
+    ProfilingApplication a(argc, argv);
+    Theme::install(a);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption measureOption("measure-transitions",
+        "Time <cycles> menu/game/end screen cycles, print the latencies and exit.", "cycles");
+    parser.addOption(measureOption);
+    QCommandLineOption recordOption("record",
+        "Record the session to <file> on exit instead of its own game_session-<time>-<seed>.json, for fmchne_replay.", "file");
+    parser.addOption(recordOption);
+    QCommandLineOption traceOption("trace",
+        "Write the span trace to <file> on exit and on F4 (tracing builds only).", "file");
+    parser.addOption(traceOption);
+    QCommandLineOption paytableOption("paytable",
+        "Play with the paytable in <file>, reloaded whenever it changes.", "file");
+    parser.addOption(paytableOption);
+    parser.process(a);
+
     MainWindow w;
+    if (parser.isSet(recordOption)) {
+        w.setSessionRecordPath(parser.value(recordOption));
+    }
+    if (parser.isSet(paytableOption)) {
+        w.setPaytablePath(parser.value(paytableOption));
+    }
+    if (parser.isSet(traceOption)) {
+        w.setTracePath(parser.value(traceOption));
+    }
     w.show();
+
+    if (parser.isSet(measureOption)) {
+        w.measureScreenTransitions(parser.value(measureOption).toInt());
+        return 0;
+    }
     return a.exec();
 }
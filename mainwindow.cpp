@@ -1,34 +1,87 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "RotatableButton.h"
+#include "AllocationCounter.h"
+#include "BalanceLabel.h"
+#include "ButtonAnimator.h"
+#include "LatencyHistogram.h"
+#include "Logging.h"
+#include "PaytableFile.h"
+#include "PerfHud.h"
+#include "ReelWidget.h"
+#include "Theme.h"
+#include "Trace.h"
 
 #include <QLabel>
 #include <QScreen>
 #include <QApplication>
 #include <QPushButton>
-#include <QGraphicsDropShadowEffect>
-#include <random>
 #include <QString>
 #include <QRect>
-#include <QPropertyAnimation>
-#include <QTimer>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QFile>
-#include <QIODevice>
-#include <QMap>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStackedWidget>
 #include <QPixmap>
+#include <QShortcut>
+#include <QWindow>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(std::make_unique<Ui::MainWindow>())
 {
+    Trace::setThreadName("UI");
     ui->setupUi(this);
     initializeScreenDimensions();
-    setupStart();
+    // Before the screens, since showing the menu already begins a run
+    m_session.start(m_engine);
+    // One file per launch, named by when it started and its seed, so a new
+    // session never overwrites an earlier one
+    m_sessionPath = QString("game_session-%1-%2.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"))
+        .arg(qulonglong(m_engine.seed()), 16, 16, QLatin1Char('0'));
+    setupScreens();
+
+    // Performance overlay, toggled with F3
+    m_perfHud = new PerfHud(this);
+    auto* hudShortcut = new QShortcut(QKeySequence(Qt::Key_F3), this);
+    connect(hudShortcut, &QShortcut::activated, m_perfHud, &PerfHud::toggle);
+
+    if (Trace::compiledIn()) {
+        // Dumps everything traced so far, e.g. right after a slow interaction
+        auto* traceShortcut = new QShortcut(QKeySequence(Qt::Key_F4), this);
+        connect(traceShortcut, &QShortcut::activated, this, &MainWindow::writeTrace);
+    }
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    // An interrupted auto spin batch has not been saved yet
+    if (m_autoPlay.isRunning()) {
+        m_autoPlay.stop();
+        saveState();
+    }
+
+    // Durably flush the last snapshot before the window goes away
+    m_saveModel.close();
+
+    if (!m_sessionPath.isEmpty()) {
+        if (writeSession(m_sessionPath, m_session.log())) {
+            qCInfo(lcSave) << "Session recorded to" << m_sessionPath;
+        } else {
+            qCWarning(lcSave) << "Could not write session to" << m_sessionPath;
+        }
+    }
+    if (Trace::compiledIn()) {
+        writeTrace();
+    }
+    const SaveWriter& writer = m_saveModel.writer();
+    qCInfo(lcPerf) << "Save submit latency:" << writer.submitLatency().summary().c_str();
+    qCInfo(lcPerf) << "Save write latency:" << writer.writeLatency().summary().c_str()
+            << "coalesced:" << writer.coalescedCount();
+    if (AllocationCounter::enabled()) {
+        qCInfo(lcPerf) << "Button animation retargets:" << ButtonAnimator::retargetCount()
+                << "heap allocations:" << ButtonAnimator::retargetAllocations();
+    }
+}
 
 void MainWindow::initializeScreenDimensions() {
     if (QScreen* screen = QApplication::primaryScreen()) {
@@ -38,372 +91,222 @@ void MainWindow::initializeScreenDimensions() {
 }
 
 void MainWindow::saveState() {
-    QJsonObject saveData;
-    
-    // Current game state
-    QJsonObject current;
-    current["Money"] = m_money;
-    current["Spins"] = m_spinCount;
-    current["MaxMoney"] = m_maxMoney;
-    
-    // Overall statistics
-    QJsonObject overall;
-    overall["TotalSpins"] = m_totalSpins;
-    overall["TotalMoneyEarnt"] = m_totalMoneyEarnt;
-    overall["HighestSpin"] = m_highestSpin;
-    overall["AllTimeHighestMoney"] = m_allTimeHighestMoney;
-    overall["Runs"] = m_runsPlayed;
-    
-    // Combine both into main object
-    saveData["Current"] = current;
-    saveData["Overall"] = overall;
-
-    QJsonDocument doc(saveData);
-    QFile file(SAVE_FILE);
-
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
-        qDebug() << "Game state saved successfully";
-    } else {
-        qDebug() << "Failed to save game state";
-    }
+    FMCHNE_TRACE_SCOPE("MainWindow::saveState");
+    SaveData data;
+    data.hasCurrent = true;
+    data.state = m_engine.state();
+    data.seed = m_engine.seed();
+    data.draws = m_engine.draws();
+
+    m_saveModel.save(data);
+    qCDebug(lcSave) << "Game state queued for saving";
 }
 
 void MainWindow::readSave() {
-    QFile file(SAVE_FILE);
+    FMCHNE_TRACE_SCOPE("MainWindow::readSave");
+    SaveData data;
     
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray saveData = file.readAll();
-        QJsonDocument doc(QJsonDocument::fromJson(saveData));
-        QJsonObject saveObj = doc.object();
-        
-        // Load current game state
-        QJsonObject current = saveObj["Current"].toObject();
-        m_money = current["Money"].toInt();
-        m_spinCount = current["Spins"].toInt();
-        m_maxMoney = current["MaxMoney"].toInt();
-        
-        // Load overall statistics
-        QJsonObject overall = saveObj["Overall"].toObject();
-        m_totalSpins = overall["TotalSpins"].toInt();
-        m_totalMoneyEarnt = overall["TotalMoneyEarnt"].toInt();
-        m_highestSpin = overall["HighestSpin"].toInt();
-        m_allTimeHighestMoney = overall["AllTimeHighestMoney"].toInt();
-	m_runsPlayed = overall["Runs"].toInt();
-        
-        file.close();
-        qDebug() << "Game state loaded successfully";
-    }
-}
-
-void MainWindow::removeSaveState() {
-    QFile file(SAVE_FILE);
-    
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray saveData = file.readAll();
-        QJsonDocument doc(QJsonDocument::fromJson(saveData));
-        QJsonObject saveObj = doc.object();
-        
-        // Remove only the current game state
-        saveObj.remove("Current");
-        
-        file.close();
-        
-        // Write back the file with only overall stats
-        if (file.open(QIODevice::WriteOnly)) {
-            QJsonDocument newDoc(saveObj);
-            file.write(newDoc.toJson());
-            file.close();
+    if (m_saveModel.loadCurrent(data)) {
+        m_engine.setState(data.state);
+        // Saves from before the RNG was recorded have no seed, keep the fresh one
+        if (data.hasCurrent && data.seed != 0) {
+            m_engine.reseed(data.seed, data.draws);
         }
+        m_session.restore(m_engine);
+        qCDebug(lcSave) << "Game state loaded successfully";
     }
 }
 
-std::vector<std::string> MainWindow::generateRandomSymbol() const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, m_symbols.size() - 1);
-    
-    std::vector<std::string> rolled;
-    rolled.reserve(3);
-    
-    // Generate 3 random symbols
-    for (int i = 0; i < 3; ++i) {
-        int randomIndex = dis(gen);
-        rolled.push_back(m_symbols[randomIndex]);
-    }
-    
-    return rolled;
+void MainWindow::removeSaveState() {
+    // Keep only the overall stats
+    m_saveModel.dropCurrent();
 }
 
 void MainWindow::updateMoneyLabel() {
     if (m_moneyLabel) {
-        m_maxMoney = std::max(m_maxMoney, m_money);
-        
-        int pounds = m_money / 100;
-        int pence = m_money % 100;
-        m_moneyLabel->setText(QString("Balance: £%1.%2")
-            .arg(pounds)
-            .arg(pence, 2, 10, QChar('0')));
+        // Formats into the label's own buffer and repaints only on change
+        m_moneyLabel->setPence(m_engine.state().money);
 
-        if (m_money < m_cost) {
+        if (!m_engine.canSpin()) {
             removeSaveState();
-            clearScreen(3);
+            showScreen(Screen::End);
         }
     }
 }
 
-bool MainWindow::hasSaveFile() const {
-    QFile file(SAVE_FILE);
-    if (file.exists()) {
-        if (file.open(QIODevice::ReadOnly)) {
-            QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-            QJsonObject obj = doc.object();
-            bool hasContent = obj.contains("Current");
-            file.close();
-            return hasContent;
-        }
+void MainWindow::writeTrace() {
+    if (Trace::writeChromeJson(m_tracePath.toStdString())) {
+        qCInfo(lcPerf) << "Trace written to" << m_tracePath;
+    } else {
+        qCWarning(lcPerf) << "Could not write trace to" << m_tracePath;
     }
-    return false;
 }
 
-bool MainWindow::hasThreeOfAKind(const std::vector<std::string>& results) const {
-    return results[0] == results[1] && results[1] == results[2];
-}
-
-bool MainWindow::hasTwoOfAKind(const std::vector<std::string>& results) const {
-    return (results[0] == results[1] || 
-            results[1] == results[2] || 
-            results[0] == results[2]);
+void MainWindow::setPaytablePath(const QString& path) {
+    delete m_paytableWatcher;
+    m_paytableWatcher = new PaytableWatcher(path, this);
+    connect(m_paytableWatcher, &PaytableWatcher::paytableChanged, this, &MainWindow::applyPaytable);
+    connect(m_paytableWatcher, &PaytableWatcher::loadFailed, this, [](const QString& error) {
+        qCWarning(lcPaytable) << "Keeping the current paytable:" << error;
+    });
+    m_paytableWatcher->reload();
 }
 
-int MainWindow::countSymbol(const std::vector<std::string>& results, const std::string& symbol) const {
-    return std::count(results.begin(), results.end(), symbol);
-}
+void MainWindow::applyPaytable() {
+    const auto compiled = m_paytableWatcher->current();
+    // Spins run on this thread, so the swap always lands between two of them
+    m_engine.setPaytable(compiled->paytable, compiled->table);
+    m_session.setPaytable(m_engine);
 
-QString MainWindow::getDefaultButtonStyle() const {
-    return QString(
-        "QPushButton {"
-        "   background-color: qlineargradient(y1: 0, y2: 1, stop: 0 #FFD700, stop: 1 #FF8C00);"
-        "   color: black;"
-        "   border-radius: 10px;"
-        "   font-size: 20px;"
-        "   font-weight: bold;"
-        "   padding: 0px;"
-        "   border: 2px solid #FFD700;"
-        "}"
-        "QPushButton:pressed {"
-        "   background-color: #FF4500;"
-        "   color: white;"
-        "}"
-    );
+    const PaytableReport& report = compiled->report;
+    qCInfo(lcPaytable).nospace() << "Paytable " << m_paytableWatcher->path() << " loaded: cost "
+        << compiled->paytable.cost << "p, exact RTP " << report.rtp * 100 << "%, hit frequency "
+        << report.hitFrequency * 100 << "%";
 }
 
-QString MainWindow::getHoverButtonStyle() const {
-    return QString(
-        "QPushButton {"
-        "   background-color: #FF6347;"
-        "   border-radius: 10px;"
-        "   font-size: 20px;"
-        "   font-weight: bold;"
-        "   padding: 10px;"
-        "   border: 2px solid #FFD700;"
-        "}"
-    );
+bool MainWindow::hasSaveFile() const {
+    FMCHNE_TRACE_SCOPE("MainWindow::hasSaveFile");
+    return m_saveModel.hasCurrentRun();
 }
 
-void MainWindow::setupButton(QPushButton* button, const QString& styleSheet) {
+void MainWindow::setupButton(QPushButton* button) {
     if (!button) return;
     
     if (auto* rotButton = qobject_cast<RotatableButton*>(button)) {
         // For RotatableButton, set the visual button size
         rotButton->setButtonSize(QSize(BUTTON_WIDTH, BUTTON_HEIGHT));
+        m_animators.insert(rotButton, new ButtonAnimator(rotButton));
     } else {
         // For regular QPushButton
         button->setFixedSize(BUTTON_WIDTH, BUTTON_HEIGHT);
     }
-    
-    button->setStyleSheet(styleSheet);
+
     button->installEventFilter(this);
 }
 
 
 void MainWindow::onButtonPressed() {
-    if (auto* button = qobject_cast<QPushButton*>(sender())) {
-        QPoint fixedPosition = button->pos();
-
-        auto* scaleAnim = new QPropertyAnimation(button, "size", this);
-        scaleAnim->setDuration(100);
-        
-        QSize startSize = button->size();
-        QSize endSize(startSize.width() * 0.9, startSize.height() * 0.9);
-        
-        scaleAnim->setStartValue(startSize);
-        scaleAnim->setEndValue(endSize);
-        
-        // Ensure position stays fixed during animation
-        connect(scaleAnim, &QPropertyAnimation::valueChanged, [button, fixedPosition]() {
-            button->move(fixedPosition);
-        });
-        
-        scaleAnim->start(QAbstractAnimation::DeleteWhenStopped);
-
-        // Update the visual style
-        button->setStyleSheet(
-            "QPushButton {"
-            "   background-color: #FF4500;"
-            "   color: white;"
-            "   border-radius: 10px;"
-            "   font-size: 20px;"
-            "   font-weight: bold;"
-            "   padding: 0px;"
-            "   border: 2px solid #FFD700;"
-            "}"
-        );
+    if (auto* animator = m_animators.value(sender())) {
+        animator->press();
     }
 }
 
 void MainWindow::onButtonReleased() {
-    if (auto* button = qobject_cast<QPushButton*>(sender())) {
-        QPoint fixedPosition = button->pos();
-
-        auto* scaleAnim = new QPropertyAnimation(button, "size", this);
-        scaleAnim->setDuration(100);
-        
-        QSize currentSize = button->size();
-        QSize originalSize(currentSize.width() / 0.9, currentSize.height() / 0.9);
-        
-        scaleAnim->setStartValue(currentSize);
-        scaleAnim->setEndValue(originalSize);
-        
-        // Ensure position stays fixed during animation
-        connect(scaleAnim, &QPropertyAnimation::valueChanged, [button, fixedPosition]() {
-            button->move(fixedPosition);
-        });
-        
-        scaleAnim->start(QAbstractAnimation::DeleteWhenStopped);
-
-        // Restore default style
-        button->setStyleSheet(getDefaultButtonStyle());
+    if (auto* animator = m_animators.value(sender())) {
+        animator->release();
     }
 }
 
 void MainWindow::onClaimButtonClicked() {
-    if (m_money > 0) {
-        m_maxMoney = std::max(m_maxMoney, m_money);
+    if (m_autoPlay.isRunning()) {
+        stopAutoSpin();
+    }
+    if (m_engine.state().money > 0) {
+        m_engine.claim();
+        m_session.claim(m_engine);
 
         removeSaveState();
-        clearScreen(3);
+        showScreen(Screen::End);
     }
 }
 
 void MainWindow::onSpinButtonClicked() {
-    qDebug() << "Spin button clicked!";
-    if (m_money >= m_cost) {
-        m_spinCount++;
-        m_totalSpins++;
-        m_highestSpin = std::max(m_spinCount, m_highestSpin);
-        m_previousMoney = m_money;
-        m_money -= m_cost;
+    FMCHNE_TRACE_SCOPE("MainWindow::onSpinButtonClicked");
+    qCDebug(lcSpin) << "Spin button clicked!";
+    if (m_autoPlay.isRunning()) {
+        return;
+    }
+    if (!m_engine.canSpin()) {
+        qCInfo(lcSpin) << "Insufficient funds!";
         updateMoneyLabel();
+        return;
+    }
 
-        std::vector<std::string> results = generateRandomSymbol();
-        
-        // Map of symbols to emojis
-        const QMap<QString, QString> symbolToEmoji{
-            {"Cherry", "🍒"},
-            {"Bell", "🔔"},
-            {"Lemon", "🍋"},
-            {"Orange", "🍊"},
-            {"Star", "⭐"},
-            {"Skull", "💀"}
-        };
-
-        // Update the reel displays with emojis
-        for (int i = 0; i < 3; ++i) {
-            if (m_reelLabels[i]) {
-                QString symbol = QString::fromStdString(results[i]);
-                m_reelLabels[i]->setText(symbolToEmoji.value(symbol));
-                qInfo() << symbol << "->" << symbolToEmoji.value(symbol);
-            }
-        }
-
-        // Check for skulls first (losses)
-        int skullCount = countSymbol(results, "Skull");
-        if (skullCount >= 3) {
-            m_money = 0;
-            qInfo() << "Game Over - Three skulls!";
-        } else if (skullCount == 2) {
-            m_money = std::max(0, m_money - 100);
-            qInfo() << "Lost £1 - Two skulls!";
-        } else {
-            // Check for wins
-            if (hasThreeOfAKind(results)) {
-                if (results[0] == "Bell") {
-                    m_money += 500;
-                    qInfo() << "Jackpot! Won £5!";
-                } else {
-                    m_money += 100;
-                    qInfo() << "Won £1 - Three of a kind!";
-                }
-            } else if (hasTwoOfAKind(results) && countSymbol(results, "Skull") == 0) {
-                m_money += 50;
-                qInfo() << "Won 50p - Two of a kind!";
-            }
-        }
+    const SpinResult result = m_engine.spin();
+    m_session.spins(m_engine);
 
-        updateMoneyLabel();
-    } else {
-        qInfo() << "Insufficient funds!";
+    // Scroll the reels onto the result; the balance below updates straight away
+    m_reels->spinTo(result.stops);
+    for (int i = 0; i < REEL_COUNT; ++i) {
+        qCDebug(lcSpin) << symbolName(result.window[0][i]) << "->" << QString::fromUtf8(symbolEmoji(result.window[0][i]));
     }
-    m_allTimeHighestMoney = std::max(m_money, m_allTimeHighestMoney);
-    if (m_money > m_previousMoney){
-        m_totalMoneyEarnt += (m_money - m_previousMoney);
+
+    switch (result.outcome) {
+        case Outcome::ThreeSkulls:
+            qCInfo(lcSpin) << "Game Over - Three skulls!";
+            break;
+        case Outcome::TwoSkulls:
+            qCDebug(lcSpin) << "Two skulls! Balance change" << result.delta;
+            break;
+        case Outcome::Jackpot:
+            qCDebug(lcSpin) << "Jackpot! Balance change" << result.delta;
+            break;
+        case Outcome::ThreeOfAKind:
+            qCDebug(lcSpin) << "Three of a kind! Balance change" << result.delta;
+            break;
+        case Outcome::Pair:
+            qCDebug(lcSpin) << "Two of a kind! Balance change" << result.delta;
+            break;
+        case Outcome::Loss:
+            break;
     }
-    updateMoneyLabel();
+
+    // Save before the label update, which drops the current run on game over
     saveState();
+    updateMoneyLabel();
 }
 
-void MainWindow::setupStart() {
-    m_runsPlayed += 1;
+QWidget* MainWindow::createScreenBase(const QString& title) {
     // Background setup
-    auto* backgroundWidget = new QWidget(this);
-    backgroundWidget->setGeometry(m_screenGeometry);
-    backgroundWidget->setStyleSheet(
-        "background-color: qlineargradient(y1: 0, y2: 1, "
-        "stop: 0 #1a001a, stop: 0.5 #330033, stop: 1 #4d004d);"
-        "border: 2px solid #FFD700;"
-    );
+    auto* backgroundWidget = new QWidget;
+    Theme::setRole(backgroundWidget, Theme::Role::Background);
 
     // Frame setup
     auto* frameWidget = new QWidget(backgroundWidget);
     frameWidget->setGeometry(m_screenGeometry.adjusted(50, 50, -50, -50));
-    frameWidget->setStyleSheet(
-        "background-color: qlineargradient(y1: 0, y2: 1, "
-        "stop: 0 #8B0000, stop: 1 #FF4500);"
-        "border-radius: 20px;"
-        "border: 5px solid #FFD700;"
-    );
+    Theme::setRole(frameWidget, Theme::Role::Frame);
 
     // Title setup
-    auto* titleLabel = new QLabel("The Fruit Machine", backgroundWidget);
+    auto* titleLabel = new QLabel(title, backgroundWidget);
     QFont titleFont = titleLabel->font();
     titleFont.setPointSize(48);
     titleFont.setBold(true);
     titleLabel->setFont(titleFont);
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("color: #FFD700;");
+    Theme::setRole(titleLabel, Theme::Role::Title);
     titleLabel->resize(m_screenGeometry.width(), TITLE_HEIGHT);
     titleLabel->move(0, 20);
 
+    return backgroundWidget;
+}
+
+void MainWindow::setupScreens() {
+    m_screens = new QStackedWidget(this);
+    m_screens->setGeometry(m_screenGeometry);
+
+    m_startScreen = setupStart();
+    m_gameScreen = gameScreen();
+    m_endScreen = endScreen();
+    m_screens->addWidget(m_startScreen);
+    m_screens->addWidget(m_gameScreen);
+    m_screens->addWidget(m_endScreen);
+    m_screens->show();
+
+    showScreen(Screen::Start);
+}
+
+QWidget* MainWindow::setupStart() {
+    FMCHNE_TRACE_SCOPE("MainWindow::setupStart");
+    auto* backgroundWidget = createScreenBase("The Fruit Machine");
+
     // Play button setup
     auto* playButton = new RotatableButton("Play!", backgroundWidget); // Changed parent
-    setupButton(playButton, getDefaultButtonStyle());
+    setupButton(playButton);
 
     // Calculate button position relative to background widget
     m_originalButtonPosition = QPoint(
-        (backgroundWidget->width() - BUTTON_WIDTH) / 2,
-        (backgroundWidget->height() / 2) + 50
+        (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
+        (m_screenGeometry.height() / 2) + 50
     );
     
     playButton->move(m_originalButtonPosition);
@@ -412,52 +315,40 @@ void MainWindow::setupStart() {
     connect(playButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
     connect(playButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
     connect(playButton, &QPushButton::clicked, this, [this]() { // Changed from released to clicked
-        clearScreen(1);
+        showScreen(Screen::Game);
     });
 
-    // Exit button setup
-    m_exitButton = new RotatableButton("Exit", backgroundWidget);
-    setupButton(m_exitButton, getDefaultButtonStyle());
-    m_exitButton->move(
+    // Continue button setup, only shown while there is a run to continue
+    m_continueButton = new RotatableButton("Continue", backgroundWidget);
+    setupButton(m_continueButton);
+    m_continueButton->move(
         (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
-        (m_screenGeometry.height() / 2) + 150  // Below claim button
+        m_originalButtonPosition.y() + BUTTON_HEIGHT + 20
     );
 
+    connect(m_continueButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
+    connect(m_continueButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
+    connect(m_continueButton, &QPushButton::clicked, this, [this]() {
+        readSave();
+        showScreen(Screen::Game);
+    });
+
+    // Exit button setup, positioned by refreshStart
+    m_exitButton = new RotatableButton("Exit", backgroundWidget);
+    setupButton(m_exitButton);
+
     connect(m_exitButton, &QPushButton::clicked, this, [this]() {
         QApplication::quit();
     });
     connect(m_exitButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
     connect(m_exitButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
 
-   if (hasSaveFile()) {
-        auto* continueButton = new RotatableButton("Continue", backgroundWidget);
-        setupButton(continueButton, getDefaultButtonStyle());
-        continueButton->move(
-            (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
-            m_originalButtonPosition.y() + BUTTON_HEIGHT + 20
-        );
-        
-        connect(continueButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
-        connect(continueButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
-        connect(continueButton, &QPushButton::clicked, this, [this]() {
-            readSave();
-            clearScreen(1);
-        });
-        continueButton->show();
-        
-        // Move exit button down if continue button exists
-        m_exitButton->move(
-            (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
-            m_originalButtonPosition.y() + (BUTTON_HEIGHT + 20) * 2
-        );
-    }
-
-    // Image setup
+    // Image setup, decoded and scaled once
     auto* imageLabel = new QLabel(backgroundWidget);
     QPixmap originalPixmap("./slots.png");  // Assuming image is in resources
 
     if (originalPixmap.isNull()) {
-        qDebug() << "Failed to load image: slots.png";
+        qCWarning(lcScreen) << "Failed to load image: slots.png";
     } else {
         // Calculate desired image size (e.g., 200x200 pixels)
         const int imageWidth = 200;
@@ -475,123 +366,52 @@ void MainWindow::setupStart() {
     
         // Calculate position to center the image
         int xPos = (m_screenGeometry.width() - scaledPixmap.width()) / 2;
-    int yPos = (m_screenGeometry.height() - scaledPixmap.height()) / 2 - 50; // Adjust -50 as needed
+        int yPos = (m_screenGeometry.height() - scaledPixmap.height()) / 2 - 50; // Adjust -50 as needed
     
         imageLabel->move(xPos, yPos);
         imageLabel->resize(scaledPixmap.size());
-        imageLabel->show();
     }
 
-
-     // Show everything
-    backgroundWidget->show();
-    frameWidget->show();
-    titleLabel->show();
-    playButton->show();
-    m_exitButton->show();
-
+    return backgroundWidget;
 }
 
-void MainWindow::gameScreen() {
-    // Background setup
-    auto* backgroundWidget = new QWidget(this);
-    backgroundWidget->setGeometry(m_screenGeometry);
-    backgroundWidget->setStyleSheet(
-        "background-color: qlineargradient(y1: 0, y2: 1, "
-        "stop: 0 #1a001a, stop: 0.5 #330033, stop: 1 #4d004d);"
-        "border: 2px solid #FFD700;"
-    );
+void MainWindow::refreshStart() {
+    FMCHNE_TRACE_SCOPE("MainWindow::refreshStart");
+    m_engine.beginRun();
+    m_session.beginRun(m_engine);
 
-    // Frame setup
-    auto* frameWidget = new QWidget(backgroundWidget);
-    frameWidget->setGeometry(m_screenGeometry.adjusted(50, 50, -50, -50));
-    frameWidget->setStyleSheet(
-        "background-color: qlineargradient(y1: 0, y2: 1, "
-        "stop: 0 #8B0000, stop: 1 #FF4500);"
-        "border-radius: 20px;"
-        "border: 5px solid #FFD700;"
+    // Move exit button down if continue button exists
+    const bool canContinue = hasSaveFile();
+    m_continueButton->setVisible(canContinue);
+    m_exitButton->move(
+        (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
+        canContinue ? m_originalButtonPosition.y() + (BUTTON_HEIGHT + 20) * 2
+                    : (m_screenGeometry.height() / 2) + 150
     );
+}
 
-    // Title setup
-    auto* titleLabel = new QLabel("The Fruit Machine", backgroundWidget);
-    QFont titleFont = titleLabel->font();
-    titleFont.setPointSize(48);
-    titleFont.setBold(true);
-    titleLabel->setFont(titleFont);
-    titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("color: #FFD700;");
-    titleLabel->resize(m_screenGeometry.width(), TITLE_HEIGHT);
-    titleLabel->move(0, 20); 
+QWidget* MainWindow::gameScreen() {
+    FMCHNE_TRACE_SCOPE("MainWindow::gameScreen");
+    auto* backgroundWidget = createScreenBase("The Fruit Machine");
 
     //Money setup
-    m_moneyLabel = new QLabel(backgroundWidget);
-    updateMoneyLabel();
+    m_moneyLabel = new BalanceLabel(backgroundWidget);
     QFont moneyLabelFont("Arial", 32);
     moneyLabelFont.setBold(true);
 
     m_moneyLabel->setFont(moneyLabelFont);
-    m_moneyLabel->setAlignment(Qt::AlignCenter);
-    m_moneyLabel->setStyleSheet(
-    "QLabel {"
-    "   color: #FFD700;"
-    "   background-color: rgba(0, 0, 0, 100);"
-    "   border: 2px solid #FFD700;"
-    "   border-radius: 15px;"
-    "   padding: 10px 20px;"
-    "   margin: 10px;"
-    "}"
-);
 
-    // Calculate the label's width based on content
-    QFontMetrics fm(moneyLabelFont);
-    int textWidth = fm.horizontalAdvance(m_moneyLabel->text()) + 100;
-    m_moneyLabel->setFixedWidth(textWidth);
-
-    // Center the label
-    m_moneyLabel->move(
-        (m_screenGeometry.width() - textWidth) / 2,
-        120
-    );
-
-  // Reels container setup
-    auto* reelsWidget = new QWidget(backgroundWidget);
-    reelsWidget->setGeometry(
+    // Reels setup
+    m_reels = new ReelWidget(REEL_WIDTH, REEL_HEIGHT, REEL_SPACING, backgroundWidget);
+    m_reels->setStrips(m_engine.reelStrips());
+    m_reels->move(
         (m_screenGeometry.width() - REELS_CONTAINER_WIDTH) / 2,
-        250,
-        REELS_CONTAINER_WIDTH,
-        REELS_CONTAINER_HEIGHT
+        250
     );
-    reelsWidget->setStyleSheet(
-        "background-color: #000000;"
-        "border-radius: 10px;"
-        "border: 3px solid #FFD700;"
-   );
-
-    // Create three separate reel slots
-    for (int i = 0; i < 3; ++i) {
-        m_reelLabels[i] = new QLabel(reelsWidget);
-        m_reelLabels[i]->setFixedSize(REEL_WIDTH, REEL_HEIGHT);
-        m_reelLabels[i]->setAlignment(Qt::AlignCenter);
-        m_reelLabels[i]->setStyleSheet(
-            "QLabel {"
-            "    background-color: #1a1a1a;"
-            "    border: 2px solid #FFD700;"
-            "    border-radius: 5px;"
-            "    color: #FFD700;"
-            "    font-size: 48px;"
-            "}"
-        );
-    
-    // Calculate X position for each reel
-    int xPos = i * (REEL_WIDTH + REEL_SPACING);
-    int yPos = 0;
-    
-    m_reelLabels[i]->move(xPos, yPos);
-    m_reelLabels[i]->setText("?");
-}
+
     // Spin button setup (moved up)
     m_spinButton = new RotatableButton("Spin", backgroundWidget);
-    setupButton(m_spinButton, getDefaultButtonStyle());
+    setupButton(m_spinButton);
     m_spinButton->move(
         (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
         500
@@ -599,7 +419,7 @@ void MainWindow::gameScreen() {
 
     // Claim button setup
     m_claimButton = new RotatableButton("Claim Winnings", backgroundWidget);
-    setupButton(m_claimButton, getDefaultButtonStyle());
+    setupButton(m_claimButton);
     m_claimButton->move(
         (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
         570
@@ -613,88 +433,175 @@ void MainWindow::gameScreen() {
     connect(m_claimButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
     connect(m_claimButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
 
-    // Show all widgets
-    backgroundWidget->show();
-    frameWidget->show();
-    titleLabel->show();
-    reelsWidget->show();
-    m_spinButton->show();
-    m_claimButton->show();
+    // Auto spin button setup
+    m_autoButton = new RotatableButton("Auto Spin", backgroundWidget);
+    setupButton(m_autoButton);
+    m_autoButton->move(
+        (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
+        640
+    );
+
+    connect(m_autoButton, &QPushButton::clicked, this, &MainWindow::onAutoSpinButtonClicked);
+    connect(m_autoButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
+    connect(m_autoButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
+
+    return backgroundWidget;
 }
 
-/*
-screenIds:
-0 - menu
-1 - gameScreen
-2 - endScreen
-*/
+void MainWindow::refreshGame() {
+    FMCHNE_TRACE_SCOPE("MainWindow::refreshGame");
+    m_reels->clear();
 
-void MainWindow::clearScreen(int screenId) {
-    qInfo() << "Screen cleared!";
-    
-    // Store the screenId for after cleanup
-    int nextScreen = screenId;
-    
-    // Schedule cleanup of existing widgets
-    const auto children = findChildren<QWidget*>();
-    for (auto* child : children) {
-        if (child && child != ui->centralwidget) {
-            child->deleteLater();
-        }
-    }
+    // May switch straight on to the end screen if the run cannot continue
+    updateMoneyLabel();
+
+    // Size the label to the balance it starts the run with
+    int textWidth = m_moneyLabel->textWidth() + 100;
+    m_moneyLabel->setFixedSize(textWidth, m_moneyLabel->sizeHint().height());
+
+    // Center the label
+    m_moneyLabel->move(
+        (m_screenGeometry.width() - textWidth) / 2,
+        120
+    );
+}
+
+void MainWindow::showScreen(Screen screen) {
+    FMCHNE_TRACE_SCOPE("MainWindow::showScreen");
+    qCDebug(lcScreen) << "Screen switched!";
 
     /*
-     Use a single-shot timer to ensure all widgets are properly cleaned up
-     before creating new ones
+     Switch first: refreshing the game screen can itself move on to the end
+     screen, and that nested switch has to be the one that sticks
     */
-    QTimer::singleShot(0, this, [this, nextScreen]() {
-        if (nextScreen == 0) {
-            qInfo() << "Start screen!";
-            setupStart();
-        } else if (nextScreen == 1) {
-            qInfo() << "Game started!";
-            gameScreen();
-        } else if (nextScreen == 3) {
-            qInfo() << "End screen!";
-            endScreen();
+    switch (screen) {
+        case Screen::Start:
+            qCDebug(lcScreen) << "Start screen!";
+            m_screens->setCurrentWidget(m_startScreen);
+            refreshStart();
+            break;
+        case Screen::Game:
+            qCDebug(lcScreen) << "Game started!";
+            m_screens->setCurrentWidget(m_gameScreen);
+            refreshGame();
+            break;
+        case Screen::End:
+            qCDebug(lcScreen) << "End screen!";
+            m_screens->setCurrentWidget(m_endScreen);
+            refreshEnd();
+            break;
+    }
+}
+
+void MainWindow::measureScreenTransitions(int cycles) {
+    // Run on a throwaway copy of the state so the measurement leaves no
+    // trace, in the session log included
+    const GameState savedState = m_engine.state();
+    m_session.setPaused(true);
+    LatencyHistogram transitions;
+    QElapsedTimer timer;
+
+    // Let the window get exposed first so repaint() really paints
+    QApplication::processEvents();
+
+    const Screen order[] = {Screen::Start, Screen::Game, Screen::End};
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        for (Screen screen : order) {
+            timer.start();
+            showScreen(screen);
+            m_screens->repaint();
+            transitions.record(static_cast<std::uint64_t>(timer.nsecsElapsed()));
         }
-    });
+    }
+
+    m_engine.setState(savedState);
+    m_session.setPaused(false);
+    m_screens->setCurrentWidget(m_startScreen);
+    qCInfo(lcPerf) << "Screen transitions over" << cycles << "menu/game/end cycles:"
+            << transitions.summary().c_str();
+}
+
+void MainWindow::onAutoSpinButtonClicked() {
+    if (m_autoPlay.isRunning()) {
+        stopAutoSpin();
+        return;
+    }
+    if (!m_engine.canSpin()) {
+        return;
+    }
+
+    m_autoPlay.start({AUTO_SPIN_COUNT, AUTO_SPIN_FLOOR});
+    m_autoButton->setText("Stop");
+    qCInfo(lcSpin) << "Auto spin started!";
+
+    // Spins are played in per-frame slices, paced by the window's frame requests
+    if (QWindow* handle = windowHandle()) {
+        handle->installEventFilter(this);
+        handle->requestUpdate();
+    }
+}
+
+void MainWindow::autoSpinFrame() {
+    FMCHNE_TRACE_SCOPE("MainWindow::autoSpinFrame");
+    QElapsedTimer budget;
+    budget.start();
+
+    const std::uint64_t playedBefore = m_autoPlay.played();
+    SpinResult last;
+    // Spin in small slices until this frame's share of time is used up
+    while (m_autoPlay.run(m_engine, AUTO_SPIN_SLICE, last) == AutoPlay::Status::Running
+           && budget.nsecsElapsed() < AUTO_SPIN_FRAME_BUDGET_NS) {
+    }
+    m_session.spins(m_engine, m_autoPlay.played() - playedBefore);
+
+    // One reel and label update for everything played this frame
+    if (m_autoPlay.played() != playedBefore) {
+        m_reels->setStops(last.stops);
+    }
+    if (m_autoPlay.isRunning()) {
+        updateMoneyLabel();
+        windowHandle()->requestUpdate();
+    } else {
+        finishAutoSpin();
+    }
+}
+
+void MainWindow::stopAutoSpin() {
+    m_autoPlay.stop();
+    finishAutoSpin();
+}
+
+void MainWindow::finishAutoSpin() {
+    m_autoButton->setText("Auto Spin");
+    qCInfo(lcSpin) << "Auto spin ended after" << m_autoPlay.played() << "spins";
+
+    // One save for the whole batch, then the label update that may end the run
+    saveState();
+    updateMoneyLabel();
 }
 
 bool MainWindow::eventFilter(QObject* watched, QEvent* event) {
-    auto* button = qobject_cast<QPushButton*>(watched);
-    if (!button) {
+    // Frame requests are never consumed, the window still has to repaint
+    if (event->type() == QEvent::UpdateRequest && watched == windowHandle()) {
+        if (m_autoPlay.isRunning()) {
+            autoSpinFrame();
+        }
+        return QMainWindow::eventFilter(watched, event);
+    }
+
+    auto* animator = m_animators.value(watched);
+    if (!animator) {
         return QMainWindow::eventFilter(watched, event);
     }
 
     switch (event->type()) {
-        case QEvent::Enter: {
-            button->setStyleSheet(getHoverButtonStyle());
-
-            auto* shadowEffect = new QGraphicsDropShadowEffect(this);
-            shadowEffect->setOffset(0, 0);
-            shadowEffect->setBlurRadius(10);
-            button->setGraphicsEffect(shadowEffect);
-
-            auto* rotationAnim = new QPropertyAnimation(button, "rotation");
-            rotationAnim->setDuration(200);
-            rotationAnim->setStartValue(0);
-            rotationAnim->setEndValue(45);
-            rotationAnim->start(QAbstractAnimation::DeleteWhenStopped);
+        case QEvent::Enter:
+            animator->hoverEnter();
             break;
-        }
-        
-        case QEvent::Leave: {
-            button->setStyleSheet(getDefaultButtonStyle());
-            button->setGraphicsEffect(nullptr);
-
-            auto* rotationAnim = new QPropertyAnimation(button, "rotation");
-            rotationAnim->setDuration(200);
-            rotationAnim->setStartValue(45);
-            rotationAnim->setEndValue(0);
-            rotationAnim->start(QAbstractAnimation::DeleteWhenStopped);
+
+        case QEvent::Leave:
+            animator->hoverLeave();
             break;
-        }
         
         default:
             return QMainWindow::eventFilter(watched, event);
@@ -703,121 +610,82 @@ bool MainWindow::eventFilter(QObject* watched, QEvent* event) {
     return true;
 }
 
-void MainWindow::endScreen() {
-    // Background setup
-    auto* backgroundWidget = new QWidget(this);
-    backgroundWidget->setGeometry(m_screenGeometry);
-    backgroundWidget->setStyleSheet(
-        "background-color: qlineargradient(y1: 0, y2: 1, "
-        "stop: 0 #1a001a, stop: 0.5 #330033, stop: 1 #4d004d);"
-        "border: 2px solid #FFD700;"
-    );
-
-    // Frame setup
-    auto* frameWidget = new QWidget(backgroundWidget);
-    frameWidget->setGeometry(m_screenGeometry.adjusted(50, 50, -50, -50));
-    frameWidget->setStyleSheet(
-        "background-color: qlineargradient(y1: 0, y2: 1, "
-        "stop: 0 #8B0000, stop: 1 #FF4500);"
-        "border-radius: 20px;"
-        "border: 5px solid #FFD700;"
-    );
-
-    // Set proper widget order first
-    frameWidget->lower();
-    backgroundWidget->lower();
 
-    // Title setup
-    auto* titleLabel = new QLabel("Game Over!", backgroundWidget);
-    QFont titleFont;
-    titleFont.setPointSize(48);
-    titleFont.setBold(true);
-    titleLabel->setFont(titleFont);
-    titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("color: #FFD700;");
-    titleLabel->resize(m_screenGeometry.width(), TITLE_HEIGHT);
-    titleLabel->move(0, 20);
+QWidget* MainWindow::endScreen() {
+    FMCHNE_TRACE_SCOPE("MainWindow::endScreen");
+    auto* backgroundWidget = createScreenBase("Game Over!");
 
-    // Stats setup
-    auto* statsLabel = new QLabel(backgroundWidget);
-    statsLabel->setText(QString(
-    "Current Game:\n"
-    "Total Spins: %1\n"
-    "Final Balance: £%2.%3\n"
-    "Highest Balance: £%4.%5\n\n"
-    "All Time Stats:\n"
-    "Total Spins: %6\n"
-    "Total Money Earned: £%7.%8\n"
-    "Highest Spins in One Game: %9\n"
-    "All-Time Highest Balance: £%10.%11\n"
-    "Runs Completed: %12")
-    .arg(m_spinCount)
-    .arg(m_money / 100).arg(m_money % 100, 2, 10, QChar('0'))
-    .arg(m_maxMoney / 100).arg(m_maxMoney % 100, 2, 10, QChar('0'))
-    .arg(m_totalSpins)
-    .arg(m_totalMoneyEarnt / 100).arg(m_totalMoneyEarnt % 100, 2, 10, QChar('0'))
-    .arg(m_highestSpin)
-    .arg(m_allTimeHighestMoney / 100).arg(m_allTimeHighestMoney % 100, 2, 10, QChar('0'))
-    .arg(m_runsPlayed)
-);
-    
+    // Stats setup, text filled in by refreshEnd
+    m_statsLabel = new QLabel(backgroundWidget);
     QFont statsFont;
     statsFont.setPointSize(18);
     statsFont.setBold(true);
-    statsLabel->setFont(statsFont);
-    statsLabel->setAlignment(Qt::AlignCenter);
-    statsLabel->setStyleSheet(
-        "color: #FFD700;"
-        "background-color: rgba(0, 0, 0, 100);"
-        "border: 2px solid #FFD700;"
-        "border-radius: 15px;"
-        "padding: 20px;"
-    );
-    statsLabel->adjustSize();
-    statsLabel->move(
-        (m_screenGeometry.width() - statsLabel->width()) / 2,
-        m_screenGeometry.height() / 2 - 270
-    );
+    m_statsLabel->setFont(statsFont);
+    m_statsLabel->setAlignment(Qt::AlignCenter);
+    Theme::setRole(m_statsLabel, Theme::Role::Stats);
 
     // Restart button setup
-    auto* restartButton = new RotatableButton("Back to Menu", this);
-    setupButton(restartButton, getDefaultButtonStyle());
+    auto* restartButton = new RotatableButton("Back to Menu", backgroundWidget);
+    setupButton(restartButton);
     restartButton->move(
         (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
         m_screenGeometry.height() / 2 + 100
     );
-    restartButton->raise();
 
     // Connect button signals
     connect(restartButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
     connect(restartButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
     connect(restartButton, &QPushButton::clicked, this, [this]() {
         // Reset game state
-        m_money = 100;
-        m_spinCount = 0;
-        m_maxMoney = 100;
-        clearScreen(0);
+        m_engine.resetRun();
+        m_session.resetRun(m_engine);
+        showScreen(Screen::Start);
     });
 
     // Exit button setup
-    m_exitButton = new RotatableButton("Exit", this);
-    setupButton(m_exitButton, getDefaultButtonStyle());
-    m_exitButton->move(
+    auto* exitButton = new RotatableButton("Exit", backgroundWidget);
+    setupButton(exitButton);
+    exitButton->move(
         (m_screenGeometry.width() - BUTTON_WIDTH) / 2,
         m_screenGeometry.height() / 2 + 190  // Below restart button
     );
 
-    connect(m_exitButton, &QPushButton::clicked, this, [this]() {
+    connect(exitButton, &QPushButton::clicked, this, [this]() {
         QApplication::quit();
     });
-    connect(m_exitButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
-    connect(m_exitButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
+    connect(exitButton, &QPushButton::pressed, this, &MainWindow::onButtonPressed);
+    connect(exitButton, &QPushButton::released, this, &MainWindow::onButtonReleased);
+
+    return backgroundWidget;
+}
 
-    // Show all widgets
-    backgroundWidget->show();
-    frameWidget->show();
-    titleLabel->show();
-    statsLabel->show();
-    restartButton->show();
-    m_exitButton->show();
+void MainWindow::refreshEnd() {
+    FMCHNE_TRACE_SCOPE("MainWindow::refreshEnd");
+    const GameState& state = m_engine.state();
+    m_statsLabel->setText(QString(
+    "Current Game:\n"
+    "Total Spins: %1\n"
+    "Final Balance: £%2.%3\n"
+    "Highest Balance: £%4.%5\n\n"
+    "All Time Stats:\n"
+    "Total Spins: %6\n"
+    "Total Money Earned: £%7.%8\n"
+    "Highest Spins in One Game: %9\n"
+    "All-Time Highest Balance: £%10.%11\n"
+    "Runs Completed: %12")
+    .arg(state.spinCount)
+    .arg(state.money / 100).arg(state.money % 100, 2, 10, QChar('0'))
+    .arg(state.maxMoney / 100).arg(state.maxMoney % 100, 2, 10, QChar('0'))
+    .arg(state.totalSpins)
+    .arg(state.totalMoneyEarnt / 100).arg(state.totalMoneyEarnt % 100, 2, 10, QChar('0'))
+    .arg(state.highestSpin)
+    .arg(state.allTimeHighestMoney / 100).arg(state.allTimeHighestMoney % 100, 2, 10, QChar('0'))
+    .arg(state.runsPlayed)
+);
+    
+    m_statsLabel->adjustSize();
+    m_statsLabel->move(
+        (m_screenGeometry.width() - m_statsLabel->width()) / 2,
+        m_screenGeometry.height() / 2 - 270
+    );
 }
@@ -2,13 +2,23 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <vector>
-#include <string>
 #include <QPushButton>
 #include <QLabel>
+#include <QStackedWidget>
+#include "AutoPlay.h"
+#include "ButtonAnimator.h"
+#include "ReelWidget.h"
 #include "RotatableButton.h"
+#include "SaveModel.h"
+#include "SessionLog.h"
+#include "SpinEngine.h"
+#include <QHash>
 #include <QString>
 
+class BalanceLabel;
+class PaytableWatcher;
+class PerfHud;
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
@@ -20,6 +30,17 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Cycles menu -> game -> end the given number of times and logs how long
+    // each switch took, repaint included. The window must be visible.
+    void measureScreenTransitions(int cycles);
+    // Every session is recorded and written beside the save on close, to a
+    // file of its own, or to this path instead
+    void setSessionRecordPath(const QString& path) { m_sessionPath = path; }
+    // Where F4 and closing the window dump the trace, in tracing builds
+    void setTracePath(const QString& path) { m_tracePath = path; }
+    // Plays with the paytable in this file, reloading it whenever it changes
+    void setPaytablePath(const QString& path);
+
 protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
@@ -27,50 +48,65 @@ private slots:
     void onButtonPressed();
     void onButtonReleased();
     void onSpinButtonClicked();
+    void onAutoSpinButtonClicked();
 
 private:
-    void setupStart();
+    friend class FmchneBench;
+    friend class FmchneAllocTest;
+
+    enum class Screen { Start, Game, End };
+
+    // Each screen is built once; switching only refreshes its dynamic parts
+    void setupScreens();
+    QWidget* createScreenBase(const QString& title);
+    QWidget* setupStart();
+    QWidget* gameScreen();
+    QWidget* endScreen();
+    void refreshStart();
+    void refreshGame();
+    void refreshEnd();
+    void showScreen(Screen screen);
     void initializeScreenDimensions();
-    void clearScreen(int screenId);
-    void gameScreen();
     void onClaimButtonClicked();
+    void autoSpinFrame();
+    void stopAutoSpin();
+    void finishAutoSpin();
     void updateMoneyLabel();
-    void endScreen();
-    bool hasThreeOfAKind(const std::vector<std::string>& results) const;
-    bool hasTwoOfAKind(const std::vector<std::string>& results) const;
-    int countSymbol(const std::vector<std::string>& results, const std::string& symbol) const; 
-    std::vector<std::string> generateRandomSymbol() const;
-    void setupButton(QPushButton* button, const QString& styleSheet);
-    QString getDefaultButtonStyle() const;
-    QString getHoverButtonStyle() const;
+    void setupButton(QPushButton* button);
     void saveState();
     void readSave();
     bool hasSaveFile() const;
     void removeSaveState();
+    void writeTrace();
+    void applyPaytable();
 
     std::unique_ptr<Ui::MainWindow> ui;
-    QLabel* m_moneyLabel = nullptr;
+    BalanceLabel* m_moneyLabel = nullptr;
+    QLabel* m_statsLabel = nullptr;
     
     // Game state
-    int m_money{100};
-    int m_cost{20};
-    std::vector<std::string> m_symbols{"Cherry", "Bell", "Lemon", "Orange", "Star", "Skull"};
-    int m_spinCount{0};
-    int m_maxMoney{100}; // Tracks highest amount of money held
-    int m_highestSpin{0};
-    int m_totalSpins{0};
-    int m_totalMoneyEarnt{0};
-    int m_allTimeHighestMoney{0};
-    int m_previousMoney{0};
-    int m_runsPlayed{0};
+    SpinEngine m_engine;
+    AutoPlay m_autoPlay;
+    SessionRecorder m_session;
+    QString m_sessionPath; // game_session-<start time>-<seed>.json unless overridden
+    QString m_tracePath{"fmchne_trace.json"};
+    PaytableWatcher* m_paytableWatcher{nullptr};
     // Layout
+    QStackedWidget* m_screens{nullptr};
+    QWidget* m_startScreen{nullptr};
+    QWidget* m_gameScreen{nullptr};
+    QWidget* m_endScreen{nullptr};
     QRect m_screenGeometry;
     QPoint m_screenCenter;
     QPoint m_originalButtonPosition;
-    QLabel* m_reelLabels[3] = {nullptr, nullptr, nullptr};  // Array to hold the three reel labels
+    ReelWidget* m_reels{nullptr};
+    PerfHud* m_perfHud{nullptr};
     RotatableButton* m_spinButton{nullptr};
     RotatableButton* m_claimButton{nullptr};
+    RotatableButton* m_autoButton{nullptr};
+    RotatableButton* m_continueButton{nullptr};
     RotatableButton* m_exitButton{nullptr};
+    QHash<QObject*, ButtonAnimator*> m_animators; // Each owned by its button
 
    // Constants
     static constexpr int BUTTON_WIDTH = 180;
@@ -79,8 +115,13 @@ private:
     static constexpr int REEL_WIDTH = 150;   // Width of each reel
     static constexpr int REEL_HEIGHT = 150;  // Height of each reel
     static constexpr int REEL_SPACING = 20;  // Space between reels
-    static constexpr int REELS_CONTAINER_WIDTH = (REEL_WIDTH * 3) + (REEL_SPACING * 2);
-    static constexpr int REELS_CONTAINER_HEIGHT = REEL_HEIGHT;
+    static constexpr int REELS_CONTAINER_WIDTH = (REEL_WIDTH * SpinEngine::REELS) + (REEL_SPACING * (SpinEngine::REELS - 1));
+    static constexpr int REELS_CONTAINER_HEIGHT = REEL_HEIGHT * SpinEngine::ROWS;
+    static constexpr std::uint64_t AUTO_SPIN_COUNT = 1000;
+    static constexpr int AUTO_SPIN_FLOOR = 0;          // Stop below this balance, in pence; 0 plays until bust
+    static constexpr std::uint64_t AUTO_SPIN_SLICE = 256;
+    static constexpr qint64 AUTO_SPIN_FRAME_BUDGET_NS = 4'000'000; // Leaves most of a 60 Hz frame for painting
     const QString SAVE_FILE = "game_save.json";
+    SaveModel m_saveModel{SAVE_FILE}; // Declared after SAVE_FILE, which it is built from
 };
 #endif // MAINWINDOW_H